@@ -0,0 +1,83 @@
+#pragma once
+#include <cstdint>
+#include <vector>
+#include "csr_graph.h"
+
+// Distance and parent of a vertex packed into one word, distance in the high half, so a
+// single compare-and-swap replaces both together. Distances must stay below 2^32 - 1,
+// the same range the int Dist of the MPI build already assumes; larger candidates are
+// never stored.
+using PackedLabel = uint64_t;
+const uint32_t PACKED_INF = UINT32_MAX;
+
+inline PackedLabel pack_label(long long dist, int parent) {
+    uint32_t d = dist >= PACKED_INF ? PACKED_INF : uint32_t(dist);
+    return PackedLabel(d) << 32 | uint32_t(parent);
+}
+inline long long label_dist(PackedLabel label) {
+    uint32_t d = label >> 32;
+    return d == PACKED_INF ? DIST_INF : d;
+}
+inline int label_parent(PackedLabel label) { return int(uint32_t(label)); }
+
+// Raises flag; true if this call raised it
+inline bool atomic_set_flag(int& flag) {
+    return __atomic_load_n(&flag, __ATOMIC_RELAXED) == 0 && __atomic_exchange_n(&flag, 1, __ATOMIC_RELAXED) == 0;
+}
+
+// Labels of every vertex for the OpenMP relaxation kernels. Threads lower labels with
+// a CAS loop instead of taking a lock; a failed CAS retries only while the candidate
+// still beats the label another thread just wrote. The drivers keep their Dist and
+// Parent arrays between batches and copy them in and out around the update kernels.
+class LabelArray {
+public:
+    void load(const std::vector<long long>& dist, const std::vector<int>& parent) {
+        labels_.resize(dist.size());
+        #pragma omp parallel for schedule(static)
+        for (size_t v = 0; v < dist.size(); ++v) labels_[v] = pack_label(dist[v], parent[v]);
+    }
+
+    void store(std::vector<long long>& dist, std::vector<int>& parent) const {
+        #pragma omp parallel for schedule(static)
+        for (size_t v = 0; v < labels_.size(); ++v) {
+            dist[v] = label_dist(labels_[v]);
+            parent[v] = label_parent(labels_[v]);
+        }
+    }
+
+    long long dist(int v) const { return label_dist(get(v)); }
+    int parent(int v) const { return label_parent(get(v)); }
+    PackedLabel get(int v) const { return __atomic_load_n(&labels_[v], __ATOMIC_RELAXED); }
+
+    // Atomic min on the distance: true if (dist, parent) replaced a longer label. An equal
+    // distance keeps the current parent, so a tie never re-flags a vertex.
+    bool relax(int v, long long dist, int parent) {
+        if (dist >= PACKED_INF) return false;
+        PackedLabel want = pack_label(dist, parent);
+        PackedLabel old = get(v);
+        while ((want >> 32) < (old >> 32)) {
+            if (__atomic_compare_exchange_n(&labels_[v], &old, want, true, __ATOMIC_RELAXED, __ATOMIC_RELAXED)) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    // Overwrites v's label, e.g. with the one its owner sent; not atomic against relax
+    void assign(int v, long long dist, int parent) { labels_[v] = pack_label(dist, parent); }
+
+    // Raises v's distance to infinity and keeps its parent; true if it was finite
+    bool invalidate(int v) {
+        PackedLabel old = get(v);
+        while (old >> 32 != PACKED_INF) {
+            PackedLabel want = PackedLabel(PACKED_INF) << 32 | uint32_t(old);
+            if (__atomic_compare_exchange_n(&labels_[v], &old, want, true, __ATOMIC_RELAXED, __ATOMIC_RELAXED)) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+private:
+    std::vector<PackedLabel> labels_;
+};
@@ -0,0 +1,214 @@
+#include "bfs.h"
+#include <algorithm>
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+namespace {
+
+int max_threads() {
+#ifdef _OPENMP
+    return omp_get_max_threads();
+#else
+    return 1;
+#endif
+}
+
+int thread_id() {
+#ifdef _OPENMP
+    return omp_get_thread_num();
+#else
+    return 0;
+#endif
+}
+
+void set_bit(std::vector<uint64_t>& bits, int v) {
+    uint64_t mask = 1ULL << (v & 63);
+    #pragma omp atomic
+    bits[v >> 6] |= mask;
+}
+
+// Returns whether the bit was already set
+bool test_and_set(std::vector<uint64_t>& bits, int v) {
+    uint64_t mask = 1ULL << (v & 63), old;
+    #pragma omp atomic capture
+    { old = bits[v >> 6]; bits[v >> 6] |= mask; }
+    return old & mask;
+}
+
+long long row_entries(const CSRGraph& graph, int v) {
+    int r = graph.row(v);
+    return r < 0 ? 0 : graph.rowEnd(r) - graph.rowBegin(r);
+}
+
+void concat(std::vector<std::vector<int>>& parts, std::vector<int>& out) {
+    for (auto& p : parts) {
+        out.insert(out.end(), p.begin(), p.end());
+        p.clear();
+    }
+}
+
+} // namespace
+
+DirectionOptimizingBFS::DirectionOptimizingBFS(const CSRGraph& graph)
+    : graph_(graph), front_((graph.numVertices() + 63) / 64, 0), next_(front_.size(), 0) {}
+
+void DirectionOptimizingBFS::run(int source, std::vector<long long>& dist, std::vector<int>& parent) {
+    dist.assign(graph_.numVertices(), DIST_INF);
+    parent.assign(graph_.numVertices(), -1);
+    levels_ = bottom_up_levels_ = 0;
+    if (source < 0 || source >= graph_.numVertices()) return;
+    dist[source] = 0;
+    run(std::vector<int>{source}, dist, parent);
+}
+
+void DirectionOptimizingBFS::topDown(const std::vector<int>& frontier, long long level,
+                                     std::vector<long long>& dist, std::vector<int>& parent,
+                                     std::vector<int>& next) {
+    std::vector<std::vector<int>> found(max_threads());
+    #pragma omp parallel
+    {
+        std::vector<int>& mine = found[thread_id()];
+        // Claim pass: dist is only read until the barrier at the end of this loop
+        #pragma omp for schedule(dynamic, 64)
+        for (size_t i = 0; i < frontier.size(); ++i) {
+            int r = graph_.row(frontier[i]);
+            if (r < 0) continue;
+            graph_.forEachEdge(r, [&](int v, int) {
+                if (dist[v] > level + 1 && !test_and_set(next_, v)) mine.push_back(v);
+            });
+        }
+    }
+    concat(found, next);
+
+    // Parent = first frontier neighbor in row order, same rule as bottom-up
+    #pragma omp parallel for schedule(dynamic, 64)
+    for (size_t i = 0; i < next.size(); ++i) {
+        int v = next[i];
+        int p = -1;
+        graph_.anyEdge(graph_.row(v), [&](int u, int) {
+            if (!inFrontier(u)) return false;
+            p = u;
+            return true;
+        });
+        dist[v] = level + 1;
+        parent[v] = p;
+    }
+}
+
+void DirectionOptimizingBFS::bottomUp(long long level, std::vector<long long>& dist, std::vector<int>& parent,
+                                      std::vector<int>& next) {
+    int n = graph_.numVertices();
+    std::vector<std::vector<int>> found(max_threads());
+    #pragma omp parallel
+    {
+        std::vector<int>& mine = found[thread_id()];
+        #pragma omp for schedule(static, 1024)
+        for (int v = 0; v < n; ++v) {
+            if (dist[v] <= level + 1) continue;
+            int r = graph_.row(v);
+            if (r < 0) continue;
+            graph_.anyEdge(r, [&](int u, int) {
+                if (!inFrontier(u)) return false;
+                dist[v] = level + 1;
+                parent[v] = u;
+                set_bit(next_, v);
+                mine.push_back(v);
+                return true;
+            });
+        }
+    }
+    concat(found, next);
+}
+
+long long DirectionOptimizingBFS::run(std::vector<int> seeds, std::vector<long long>& dist,
+                                      std::vector<int>& parent) {
+    int n = graph_.numVertices();
+    levels_ = bottom_up_levels_ = 0;
+
+    // Seeds ordered by the level at which they join the frontier
+    std::vector<std::pair<long long, int>> pending;
+    for (int v : seeds) {
+        if (v >= 0 && v < n && dist[v] != DIST_INF) pending.push_back({dist[v], v});
+    }
+    std::sort(pending.begin(), pending.end());
+    pending.erase(std::unique(pending.begin(), pending.end()), pending.end());
+
+    long long unexplored = 0;
+    #pragma omp parallel for reduction(+ : unexplored)
+    for (int v = 0; v < n; ++v) {
+        if (dist[v] == DIST_INF) unexplored += row_entries(graph_, v);
+    }
+
+    std::vector<int> frontier, next;
+    long long improved = 0;
+    bool bottom_up = false;
+    size_t next_seed = 0;
+    long long level = pending.empty() ? 0 : pending[0].first;
+    while (true) {
+        for (; next_seed < pending.size() && pending[next_seed].first <= level; ++next_seed) {
+            int v = pending[next_seed].second;
+            if (dist[v] != level || inFrontier(v)) continue;
+            front_[v >> 6] |= 1ULL << (v & 63);
+            frontier.push_back(v);
+        }
+        if (frontier.empty()) {
+            if (next_seed == pending.size()) break;
+            level = pending[next_seed].first;
+            continue;
+        }
+
+        long long frontier_edges = 0;
+        for (int v : frontier) frontier_edges += row_entries(graph_, v);
+        if (!bottom_up && frontier_edges > unexplored / BFS_ALPHA) bottom_up = true;
+        else if (bottom_up && frontier.size() < n / BFS_BETA) bottom_up = false;
+
+        next.clear();
+        if (bottom_up) {
+            bottomUp(level, dist, parent, next);
+            ++bottom_up_levels_;
+        } else {
+            topDown(frontier, level, dist, parent, next);
+        }
+        ++levels_;
+        improved += next.size();
+        for (int v : next) unexplored -= row_entries(graph_, v);
+        unexplored = std::max(0LL, unexplored);
+
+        // front_ holds exactly the frontier's bits, so zeroing their words empties it
+        for (int v : frontier) front_[v >> 6] = 0;
+        front_.swap(next_);
+        frontier.swap(next);
+        ++level;
+    }
+    return improved;
+}
+
+long long DirectionOptimizingBFS::repair(const std::vector<int>& affected, std::vector<long long>& dist,
+                                         std::vector<int>& parent) {
+    // Pull pass over every affected vertex, since an insertion may have lowered one only part
+    // of the way. Everything is read before anything is written, so the result is order independent
+    std::vector<std::pair<long long, int>> pulled(affected.size(), {DIST_INF, -1});
+    #pragma omp parallel for schedule(dynamic, 64)
+    for (size_t i = 0; i < affected.size(); ++i) {
+        int v = affected[i];
+        int r = graph_.row(v);
+        if (r < 0) continue;
+        pulled[i].first = dist[v];
+        graph_.forEachEdge(r, [&](int u, int w) {
+            if (dist[u] != DIST_INF && dist[u] + w < pulled[i].first) pulled[i] = {dist[u] + w, u};
+        });
+    }
+    long long improved = 0;
+    std::vector<int> seeds;
+    for (size_t i = 0; i < affected.size(); ++i) {
+        int v = affected[i];
+        if (pulled[i].second >= 0) {
+            dist[v] = pulled[i].first;
+            parent[v] = pulled[i].second;
+            ++improved;
+        }
+        if (dist[v] != DIST_INF) seeds.push_back(v);
+    }
+    return improved + run(std::move(seeds), dist, parent);
+}
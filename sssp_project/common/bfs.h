@@ -0,0 +1,48 @@
+#pragma once
+#include <cstdint>
+#include <vector>
+#include "csr_graph.h"
+
+// Beamer et al.'s direction switching thresholds
+const double BFS_ALPHA = 15.0;
+const double BFS_BETA = 18.0;
+
+// Direction-optimizing BFS (Beamer, Asanovic & Patterson) for unit-weight graphs whose
+// rows cover every vertex. Each level either pushes from the frontier list (top-down)
+// or lets every unreached vertex look for a neighbor in the frontier bitmap
+// (bottom-up). It switches to bottom-up once the frontier's edges exceed 1/alpha of
+// the edges still unexplored, and back when the frontier drops below |V|/beta.
+//
+// Parents are the first frontier neighbor in row order whichever direction a level
+// ran in, so results do not depend on the thread count or the direction chosen.
+class DirectionOptimizingBFS {
+public:
+    explicit DirectionOptimizingBFS(const CSRGraph& graph);
+
+    // Single-source run; dist/parent are reset to DIST_INF / -1 first
+    void run(int source, std::vector<long long>& dist, std::vector<int>& parent);
+
+    // Continues from the caller's dist/parent: seeds enter the frontier at their current
+    // distance and every vertex whose distance can be lowered is. Returns the number of
+    // vertices improved.
+    long long run(std::vector<int> seeds, std::vector<long long>& dist, std::vector<int>& parent);
+
+    // Repair after edge updates: vertices in `affected` first take their best neighbor
+    // (invalidated ones are at DIST_INF), then all of them with a finite distance are seeds.
+    long long repair(const std::vector<int>& affected, std::vector<long long>& dist, std::vector<int>& parent);
+
+    int levels() const { return levels_; }
+    int bottomUpLevels() const { return bottom_up_levels_; }
+
+private:
+    void topDown(const std::vector<int>& frontier, long long level, std::vector<long long>& dist,
+                 std::vector<int>& parent, std::vector<int>& next);
+    void bottomUp(long long level, std::vector<long long>& dist, std::vector<int>& parent,
+                  std::vector<int>& next);
+    bool inFrontier(int v) const { return (front_[v >> 6] >> (v & 63)) & 1; }
+
+    const CSRGraph& graph_;
+    std::vector<uint64_t> front_, next_;
+    int levels_ = 0;
+    int bottom_up_levels_ = 0;
+};
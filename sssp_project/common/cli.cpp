@@ -0,0 +1,34 @@
+#include "cli.h"
+
+CommandLine::CommandLine(int argc, char** argv) {
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg.rfind("--", 0) != 0) continue;
+        std::string name = arg.substr(2);
+        auto eq = name.find('=');
+        if (eq != std::string::npos) {
+            values_[name.substr(0, eq)] = name.substr(eq + 1);
+        } else if (i + 1 < argc && std::string(argv[i + 1]).rfind("--", 0) != 0) {
+            values_[name] = argv[++i];
+        } else {
+            values_[name] = "";
+        }
+    }
+}
+
+bool CommandLine::has(const std::string& name) const { return values_.count(name) != 0; }
+
+std::string CommandLine::get(const std::string& name, const std::string& def) const {
+    auto it = values_.find(name);
+    return it == values_.end() ? def : it->second;
+}
+
+long long CommandLine::getInt(const std::string& name, long long def) const {
+    auto it = values_.find(name);
+    return it == values_.end() || it->second.empty() ? def : std::stoll(it->second);
+}
+
+double CommandLine::getDouble(const std::string& name, double def) const {
+    auto it = values_.find(name);
+    return it == values_.end() || it->second.empty() ? def : std::stod(it->second);
+}
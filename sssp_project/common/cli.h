@@ -0,0 +1,17 @@
+#pragma once
+#include <string>
+#include <unordered_map>
+
+// Minimal "--name value" / "--flag" parser shared by the drivers and tools
+class CommandLine {
+public:
+    CommandLine(int argc, char** argv);
+
+    bool has(const std::string& name) const;
+    std::string get(const std::string& name, const std::string& def) const;
+    long long getInt(const std::string& name, long long def) const;
+    double getDouble(const std::string& name, double def) const;
+
+private:
+    std::unordered_map<std::string, std::string> values_;
+};
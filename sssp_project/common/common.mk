@@ -0,0 +1,12 @@
+# Shared graph core, compiled into each build with that build's own flags.
+# Include from a build directory after setting CXX/CXXFLAGS.
+COMMON_DIR = ../common
+COMMON_SRCS = csr_graph.cpp graph_io.cpp text_parser.cpp mapped_file.cpp cli.cpp partitioner.cpp delta_stepping.cpp bfs.cpp dijkstra.cpp multi_source.cpp point_to_point.cpp landmarks.cpp update_stream.cpp sssp_tree.cpp workload.cpp distance_store.cpp
+COMMON_OBJS = $(COMMON_SRCS:.cpp=.o)
+
+%.o: $(COMMON_DIR)/%.cpp $(COMMON_DIR)/*.h
+	$(CXX) $(CXXFLAGS) -I$(COMMON_DIR) -c $< -o $@
+
+# MPI-only sources, linked by the mpi and mpi-openmp builds
+COMMON_MPI_SRCS = dist_loader.cpp dist_delta_stepping.cpp dist_bfs.cpp vertex_map.cpp ghost_exchange.cpp
+COMMON_MPI_OBJS = $(COMMON_MPI_SRCS:.cpp=.o)
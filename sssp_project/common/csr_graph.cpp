@@ -0,0 +1,226 @@
+#include "csr_graph.h"
+#include <algorithm>
+
+CSRGraph CSRGraph::fromEntries(int num_vertices, const std::vector<std::pair<int, int>>& entries,
+                               const std::vector<int>& weights) {
+    return build(num_vertices, nullptr, entries, weights);
+}
+
+CSRGraph CSRGraph::fromEntries(int num_vertices, const std::vector<int>& rowVertices,
+                               const std::vector<std::pair<int, int>>& entries,
+                               const std::vector<int>& weights) {
+    return build(num_vertices, &rowVertices, entries, weights);
+}
+
+CSRGraph CSRGraph::build(int num_vertices, const std::vector<int>* rowVertices,
+                         const std::vector<std::pair<int, int>>& entries,
+                         const std::vector<int>& weights) {
+    CSRGraph g;
+    g.num_vertices_ = num_vertices;
+    if (rowVertices) {
+        g.rowVertex_ = *rowVertices;
+        g.rowOf_.assign(num_vertices, -1);
+        for (int r = 0; r < (int)g.rowVertex_.size(); ++r) g.rowOf_[g.rowVertex_[r]] = r;
+        g.num_rows_ = g.rowVertex_.size();
+    } else {
+        g.num_rows_ = num_vertices;
+    }
+
+    // Counting sort of entries by source row
+    g.offsetStorage_.assign(g.num_rows_ + 1, 0);
+    for (const auto& [u, v] : entries) {
+        int r = g.row(u);
+        if (r >= 0) g.offsetStorage_[r + 1]++;
+    }
+    for (int r = 0; r < g.num_rows_; ++r) g.offsetStorage_[r + 1] += g.offsetStorage_[r];
+
+    std::vector<long long> next(g.offsetStorage_.begin(), g.offsetStorage_.end() - 1);
+    g.adjStorage_.resize(g.offsetStorage_[g.num_rows_]);
+    if (!weights.empty()) g.weightStorage_.resize(g.adjStorage_.size());
+    for (size_t i = 0; i < entries.size(); ++i) {
+        int r = g.row(entries[i].first);
+        if (r < 0) continue;
+        long long slot = next[r]++;
+        g.adjStorage_[slot] = entries[i].second;
+        if (!weights.empty()) g.weightStorage_[slot] = weights[i];
+    }
+
+    g.bind();
+    g.localVertices.reserve(g.num_rows_);
+    for (int r = 0; r < g.num_rows_; ++r) g.localVertices.push_back(g.vertex(r));
+    return g;
+}
+
+CSRGraph CSRGraph::fromCSR(int num_vertices, std::vector<long long> offsets, std::vector<int> adj,
+                           std::vector<int> weights) {
+    CSRGraph g;
+    g.num_vertices_ = num_vertices;
+    g.num_rows_ = num_vertices;
+    g.offsetStorage_ = std::move(offsets);
+    g.adjStorage_ = std::move(adj);
+    g.weightStorage_ = std::move(weights);
+    g.bind();
+    g.localVertices.resize(num_vertices);
+    for (int v = 0; v < num_vertices; ++v) g.localVertices[v] = v;
+    return g;
+}
+
+CSRGraph CSRGraph::fromRows(int num_vertices, std::vector<int> rowVertices, std::vector<long long> offsets,
+                            std::vector<int> adj, std::vector<int> weights) {
+    CSRGraph g;
+    g.num_vertices_ = num_vertices;
+    g.num_rows_ = rowVertices.size();
+    g.rowOf_.assign(num_vertices, -1);
+    for (int r = 0; r < g.num_rows_; ++r) g.rowOf_[rowVertices[r]] = r;
+    g.localVertices = rowVertices;
+    g.rowVertex_ = std::move(rowVertices);
+    g.offsetStorage_ = std::move(offsets);
+    g.adjStorage_ = std::move(adj);
+    g.weightStorage_ = std::move(weights);
+    g.bind();
+    return g;
+}
+
+CSRGraph CSRGraph::fromArrays(int num_vertices, const long long* offsets, const int* adj, const int* wts,
+                              std::shared_ptr<const void> backing) {
+    CSRGraph g;
+    g.num_vertices_ = num_vertices;
+    g.num_rows_ = num_vertices;
+    g.offsets_ = offsets;
+    g.adj_ = adj;
+    g.wts_ = wts;
+    g.backing_ = std::move(backing);
+    g.localVertices.resize(num_vertices);
+    for (int v = 0; v < num_vertices; ++v) g.localVertices[v] = v;
+    return g;
+}
+
+void CSRGraph::bind() {
+    offsets_ = offsetStorage_.data();
+    adj_ = adjStorage_.data();
+    // A graph whose weights are all 1 is stored without a weight array
+    bool unit = std::all_of(weightStorage_.begin(), weightStorage_.end(), [](int w) { return w == 1; });
+    if (unit) weightStorage_.clear();
+    wts_ = weightStorage_.empty() ? nullptr : weightStorage_.data();
+}
+
+int CSRGraph::degree(int r) const {
+    int d = 0;
+    forEachEdge(r, [&](int, int) { ++d; });
+    return d;
+}
+
+bool CSRGraph::hasEdge(int r, int dest) const {
+    return findSlot(r, dest) != NO_SLOT;
+}
+
+long long CSRGraph::findSlot(int r, int dest) const {
+    if (!hubs_.empty() && !hubs_[r].empty()) {
+        auto it = hubs_[r].find(dest);
+        return it == hubs_[r].end() ? NO_SLOT : it->second;
+    }
+    for (long long i = offsets_[r]; i < offsets_[r + 1]; ++i) {
+        if (adj_[i] == dest && !removed(i)) return i;
+    }
+    if (!inserted_.empty()) {
+        const auto& extra = inserted_[r];
+        for (size_t k = 0; k < extra.size(); ++k) {
+            if (extra[k].dest == dest) return ~(long long)k;
+        }
+    }
+    return NO_SLOT;
+}
+
+// Index of a row with at least HUB_DEGREE slots, built on first use; null for other rows.
+// Duplicate CSR entries are dropped while indexing so each edge has exactly one slot.
+std::unordered_map<int, long long>* CSRGraph::hubIndex(int r) {
+    long long slots = offsets_[r + 1] - offsets_[r] + (inserted_.empty() ? 0 : inserted_[r].size());
+    if (slots < HUB_DEGREE) return nullptr;
+    if (hubs_.empty()) hubs_.resize(num_rows_);
+    auto& index = hubs_[r];
+    if (!index.empty()) return &index;
+    index.reserve(slots);
+    for (long long i = offsets_[r]; i < offsets_[r + 1]; ++i) {
+        if (removed(i)) continue;
+        if (!index.emplace(adj_[i], i).second) killSlot(r, i);
+    }
+    if (!inserted_.empty()) {
+        auto& extra = inserted_[r];
+        for (size_t k = 0; k < extra.size(); ++k) {
+            if (extra[k].dest >= 0 && !index.emplace(extra[k].dest, ~(long long)k).second) killSlot(r, ~(long long)k);
+        }
+    }
+    return &index;
+}
+
+void CSRGraph::killSlot(int r, long long slot) {
+    if (slot >= 0) {
+        if (removed_.empty()) removed_.assign(numEntries(), 0);
+        removed_[slot] = 1;
+    } else {
+        inserted_[r][~slot].dest = -1;
+    }
+    ++overlaySlots_;
+}
+
+void CSRGraph::insertEdge(int r, int dest, int weight) {
+    hubIndex(r);  // a hub row gets its index before the lookup
+    long long slot = findSlot(r, dest);
+    if (slot != NO_SLOT) {
+        int current = slot >= 0 ? (wts_ ? wts_[slot] : 1) : inserted_[r][~slot].weight;
+        if (current == weight) return;
+        killSlot(r, slot);
+    }
+    if (inserted_.empty()) inserted_.resize(num_rows_);
+    inserted_[r].push_back({dest, weight});
+    if (!hubs_.empty() && !hubs_[r].empty()) hubs_[r][dest] = ~(long long)(inserted_[r].size() - 1);
+    ++overlaySlots_;
+    if (weight != 1) weightedInsert_ = true;
+    if (overlaySlots_ >= OVERLAY_COMPACT_MIN && overlaySlots_ * OVERLAY_COMPACT_RATIO > numEntries()) {
+        compact();
+    }
+}
+
+bool CSRGraph::eraseEdge(int r, int dest) {
+    auto* index = hubIndex(r);
+    if (index) {
+        auto it = index->find(dest);
+        if (it == index->end()) return false;
+        killSlot(r, it->second);
+        index->erase(it);
+    } else {
+        // Unindexed rows may still hold a duplicate CSR entry
+        long long slot = findSlot(r, dest);
+        if (slot == NO_SLOT) return false;
+        for (; slot != NO_SLOT; slot = findSlot(r, dest)) killSlot(r, slot);
+    }
+    if (overlaySlots_ >= OVERLAY_COMPACT_MIN && overlaySlots_ * OVERLAY_COMPACT_RATIO > numEntries()) {
+        compact();
+    }
+    return true;
+}
+
+void CSRGraph::compact() {
+    if (removed_.empty() && inserted_.empty()) return;
+    std::vector<long long> offsets(num_rows_ + 1, 0);
+    std::vector<int> adj, weights;
+    adj.reserve(numEntries() + overlaySlots_);
+    bool weighted = wts_ != nullptr || weightedInsert_;
+    for (int r = 0; r < num_rows_; ++r) {
+        forEachEdge(r, [&](int v, int w) {
+            adj.push_back(v);
+            if (weighted) weights.push_back(w);
+        });
+        offsets[r + 1] = adj.size();
+    }
+    offsetStorage_ = std::move(offsets);
+    adjStorage_ = std::move(adj);
+    weightStorage_ = std::move(weights);
+    backing_.reset();
+    removed_.clear();
+    inserted_.clear();
+    hubs_.clear();
+    overlaySlots_ = 0;
+    weightedInsert_ = false;
+    bind();
+}
@@ -0,0 +1,143 @@
+#pragma once
+#include <vector>
+#include <utility>
+#include <limits>
+#include <memory>
+#include <unordered_map>
+
+const long long DIST_INF = std::numeric_limits<long long>::max();
+
+// Rows with at least this many slots get a hashed neighbor index once they are updated
+const int HUB_DEGREE = 256;
+// The update overlay is folded back into CSR arrays once its tombstones and inserted
+// edges exceed 1/OVERLAY_COMPACT_RATIO of the entries (and OVERLAY_COMPACT_MIN)
+const int OVERLAY_COMPACT_RATIO = 4;
+const long long OVERLAY_COMPACT_MIN = 1024;
+
+struct Edge {
+    int dest;
+    int weight;
+};
+
+// Compressed sparse row adjacency shared by the seq, mpi and mpi-openmp builds.
+// Rows either cover every vertex (row == vertex id) or only the vertices a rank
+// holds, in which case row()/vertex() translate between row indices and global ids.
+// Neighbor ids are always global vertex ids.
+class CSRGraph {
+public:
+    CSRGraph() = default;
+    CSRGraph(const CSRGraph&) = delete;
+    CSRGraph& operator=(const CSRGraph&) = delete;
+    CSRGraph(CSRGraph&&) = default;
+    CSRGraph& operator=(CSRGraph&&) = default;
+
+    // Builds rows for every vertex from directed (u, v) entries; weights may be empty (unit).
+    static CSRGraph fromEntries(int num_vertices, const std::vector<std::pair<int, int>>& entries,
+                                const std::vector<int>& weights = {});
+    // Builds rows only for rowVertices (global ids); entries whose source is not listed are dropped.
+    static CSRGraph fromEntries(int num_vertices, const std::vector<int>& rowVertices,
+                                const std::vector<std::pair<int, int>>& entries,
+                                const std::vector<int>& weights = {});
+    // Takes ownership of ready-made CSR arrays (rows for every vertex)
+    static CSRGraph fromCSR(int num_vertices, std::vector<long long> offsets, std::vector<int> adj,
+                            std::vector<int> weights);
+    // Takes ownership of ready-made CSR arrays for the rows of rowVertices only
+    static CSRGraph fromRows(int num_vertices, std::vector<int> rowVertices, std::vector<long long> offsets,
+                             std::vector<int> adj, std::vector<int> weights);
+    // Wraps arrays owned by someone else (e.g. a read-only mmap); backing keeps them alive.
+    // wts may be null for unit weights.
+    static CSRGraph fromArrays(int num_vertices, const long long* offsets, const int* adj, const int* wts,
+                               std::shared_ptr<const void> backing);
+
+    int numVertices() const { return num_vertices_; }
+    int numRows() const { return num_rows_; }
+    long long numEntries() const { return num_rows_ ? offsets_[num_rows_] : 0; }
+    bool unitWeights() const { return wts_ == nullptr && !weightedInsert_; }
+
+    int row(int v) const {
+        if (v < 0 || v >= num_vertices_) return -1;
+        return rowOf_.empty() ? v : rowOf_[v];
+    }
+    int vertex(int r) const { return rowVertex_.empty() ? r : rowVertex_[r]; }
+
+    long long rowBegin(int r) const { return offsets_[r]; }
+    long long rowEnd(int r) const { return offsets_[r + 1]; }
+    int degree(int r) const;
+    int dest(long long i) const { return adj_[i]; }
+    int weight(long long i) const { return wts_ ? wts_[i] : 1; }
+    bool removed(long long i) const { return !removed_.empty() && removed_[i]; }
+
+    // Visits every live edge of row r, including edges inserted after construction.
+    template <class F>
+    void forEachEdge(int r, F&& f) const {
+        for (long long i = offsets_[r]; i < offsets_[r + 1]; ++i) {
+            if (!removed_.empty() && removed_[i]) continue;
+            f(adj_[i], wts_ ? wts_[i] : 1);
+        }
+        if (!inserted_.empty()) {
+            for (const Edge& e : inserted_[r]) {
+                if (e.dest >= 0) f(e.dest, e.weight);
+            }
+        }
+    }
+
+    // Like forEachEdge, but stops at the first edge for which f returns true
+    template <class F>
+    bool anyEdge(int r, F&& f) const {
+        for (long long i = offsets_[r]; i < offsets_[r + 1]; ++i) {
+            if (!removed_.empty() && removed_[i]) continue;
+            if (f(adj_[i], wts_ ? wts_[i] : 1)) return true;
+        }
+        if (!inserted_.empty()) {
+            for (const Edge& e : inserted_[r]) {
+                if (e.dest >= 0 && f(e.dest, e.weight)) return true;
+            }
+        }
+        return false;
+    }
+
+    // Edge updates go to an overlay: tombstones over the CSR entries plus per-row inserted
+    // edges. Rows of at least HUB_DEGREE slots are looked up through a hash index, the
+    // rest by scanning their few slots, so each update costs O(1) expected for hubs.
+    // Inserting an existing edge changes its weight instead of adding a duplicate.
+    // Updates must not run concurrently with other accesses.
+    bool hasEdge(int r, int dest) const;
+    void insertEdge(int r, int dest, int weight);
+    bool eraseEdge(int r, int dest);
+    // Folds the overlay back into plain CSR arrays; runs on its own once the overlay grows
+    void compact();
+
+    std::vector<int> localVertices; // vertices owned by this process
+
+private:
+    static CSRGraph build(int num_vertices, const std::vector<int>* rowVertices,
+                          const std::vector<std::pair<int, int>>& entries, const std::vector<int>& weights);
+    void bind();
+
+    // Overlay slots: >= 0 is a CSR entry, ~k is inserted_[r][k]
+    static constexpr long long NO_SLOT = std::numeric_limits<long long>::min();
+    long long findSlot(int r, int dest) const;
+    std::unordered_map<int, long long>* hubIndex(int r);
+    void killSlot(int r, long long slot);
+
+    int num_vertices_ = 0;
+    int num_rows_ = 0;
+    const long long* offsets_ = nullptr;
+    const int* adj_ = nullptr;
+    const int* wts_ = nullptr;
+
+    std::vector<long long> offsetStorage_;
+    std::vector<int> adjStorage_;
+    std::vector<int> weightStorage_;
+    std::vector<int> rowVertex_;
+    std::vector<int> rowOf_;
+    std::shared_ptr<const void> backing_;
+
+    // Dynamic-update overlay: removed base entries and per-row inserted edges (dest -1
+    // once erased), with hash indexes for the hub rows that were updated
+    std::vector<unsigned char> removed_;
+    std::vector<std::vector<Edge>> inserted_;
+    std::vector<std::unordered_map<int, long long>> hubs_;
+    long long overlaySlots_ = 0;  // tombstones plus inserted edges
+    bool weightedInsert_ = false;
+};
@@ -0,0 +1,199 @@
+#include "delta_stepping.h"
+#include <algorithm>
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+namespace {
+
+int max_threads() {
+#ifdef _OPENMP
+    return omp_get_max_threads();
+#else
+    return 1;
+#endif
+}
+
+int team_size() {
+#ifdef _OPENMP
+    return omp_get_num_threads();
+#else
+    return 1;
+#endif
+}
+
+int thread_id() {
+#ifdef _OPENMP
+    return omp_get_thread_num();
+#else
+    return 0;
+#endif
+}
+
+} // namespace
+
+void local_edge_stats(const CSRGraph& graph, int& max_weight, long long& entries) {
+    const std::vector<int>& owned = graph.localVertices;
+    int mw = 1;
+    long long count = 0;
+    #pragma omp parallel for schedule(dynamic, 256) reduction(max : mw) reduction(+ : count)
+    for (size_t i = 0; i < owned.size(); ++i) {
+        int r = graph.row(owned[i]);
+        if (r < 0) continue;
+        graph.forEachEdge(r, [&](int, int w) {
+            mw = std::max(mw, w);
+            ++count;
+        });
+    }
+    max_weight = mw;
+    entries = count;
+}
+
+long long default_delta(long long max_weight, long long entries, long long vertices) {
+    double avg_degree = vertices > 0 ? std::max(1.0, (double)entries / vertices) : 1.0;
+    return std::max(1LL, (long long)(max_weight / avg_degree));
+}
+
+void SplitRows::build(const CSRGraph& graph, long long d) {
+    delta = d;
+    int rows = graph.numRows();
+    const std::vector<int>& owned = graph.localVertices;
+    std::vector<long long> counts(rows + 1, 0);
+    #pragma omp parallel for schedule(dynamic, 256)
+    for (size_t i = 0; i < owned.size(); ++i) {
+        int r = graph.row(owned[i]);
+        if (r < 0) continue;
+        long long deg = 0;
+        graph.forEachEdge(r, [&](int, int) { ++deg; });
+        counts[r + 1] = deg;
+    }
+    offsets.assign(rows + 1, 0);
+    for (int r = 0; r < rows; ++r) offsets[r + 1] = offsets[r] + counts[r + 1];
+    light_end.assign(offsets.begin(), offsets.end() - 1);
+    edges.resize(offsets[rows]);
+
+    #pragma omp parallel for schedule(dynamic, 256)
+    for (int r = 0; r < rows; ++r) {
+        if (offsets[r + 1] == offsets[r]) continue;
+        long long light = offsets[r], heavy = offsets[r + 1];
+        graph.forEachEdge(r, [&](int v, int w) {
+            if (w <= delta) edges[light++] = {v, w};
+            else edges[--heavy] = {v, w};
+        });
+        light_end[r] = light;
+    }
+}
+
+DeltaStepping::DeltaStepping(const CSRGraph& graph, long long delta) : graph_(graph), threads_(max_threads()) {
+    if (delta <= 0) {
+        int max_weight;
+        long long entries;
+        local_edge_stats(graph, max_weight, entries);
+        delta = default_delta(max_weight, entries, graph.localVertices.size());
+    }
+    rows_.build(graph, delta);
+    requests_.assign(threads_, std::vector<std::vector<Request>>(threads_));
+    improved_.assign(threads_, {});
+}
+
+long long DeltaStepping::run(int source, std::vector<long long>& dist, std::vector<int>& parent) {
+    dist.assign(graph_.numVertices(), DIST_INF);
+    parent.assign(graph_.numVertices(), -1);
+    if (source < 0 || source >= graph_.numVertices()) return 0;
+    dist[source] = 0;
+    return run(std::vector<int>{source}, dist, parent);
+}
+
+void DeltaStepping::relax(const std::vector<int>& frontier, bool light, std::vector<long long>& dist,
+                          std::vector<int>& parent, long long& improved) {
+    long long count = 0;
+    for (auto& mine : improved_) mine.clear();
+    #pragma omp parallel num_threads(threads_) reduction(+ : count)
+    {
+        // The team may come out smaller than requested; ownership follows the real size
+        int threads = team_size();
+        int tid = thread_id();
+        std::vector<std::vector<Request>>& out = requests_[tid];
+        for (auto& o : out) o.clear();
+
+        // Generate: reads only, so no thread writes dist until the barrier below
+        #pragma omp for schedule(dynamic, 64)
+        for (size_t i = 0; i < frontier.size(); ++i) {
+            int u = frontier[i];
+            int r = graph_.row(u);
+            if (r < 0) continue;
+            long long du = dist[u];
+            long long begin = light ? rows_.offsets[r] : rows_.light_end[r];
+            long long end = light ? rows_.light_end[r] : rows_.offsets[r + 1];
+            for (long long e = begin; e < end; ++e) {
+                int v = rows_.edges[e].dest;
+                long long nd = du + rows_.edges[e].weight;
+                if (nd < dist[v]) out[v % threads].push_back({v, u, nd});
+            }
+        }
+
+        // Apply: each thread owns the targets v with v % threads == tid
+        std::vector<int>& mine = improved_[tid];
+        for (int src = 0; src < threads; ++src) {
+            for (const Request& req : requests_[src][tid]) {
+                if (req.dist < dist[req.v]) {
+                    dist[req.v] = req.dist;
+                    parent[req.v] = req.parent;
+                    mine.push_back(req.v);
+                    ++count;
+                }
+            }
+        }
+    }
+    improved += count;
+
+    // Merge the per-thread bucket insertions; stale entries are skipped when popped
+    for (const auto& mine : improved_) {
+        for (int v : mine) {
+            size_t b = dist[v] / rows_.delta;
+            if (b >= buckets_.size()) buckets_.resize(b + 1);
+            buckets_[b].push_back(v);
+        }
+    }
+}
+
+long long DeltaStepping::run(const std::vector<int>& seeds, std::vector<long long>& dist,
+                             std::vector<int>& parent) {
+    int n = graph_.numVertices();
+    long long improved = 0;
+    buckets_.clear();
+    for (int v : seeds) {
+        if (v < 0 || v >= n || dist[v] == DIST_INF) continue;
+        size_t b = dist[v] / rows_.delta;
+        if (b >= buckets_.size()) buckets_.resize(b + 1);
+        buckets_[b].push_back(v);
+    }
+
+    std::vector<int> frontier_mark(n, -1);
+    std::vector<char> settled_mark(n, 0);
+    std::vector<int> frontier, settled, pending;
+    int phase = 0;
+    for (size_t b = 0; b < buckets_.size(); ++b) {
+        settled.clear();
+        while (!buckets_[b].empty()) {
+            pending.clear();
+            pending.swap(buckets_[b]);
+            frontier.clear();
+            for (int v : pending) {
+                if ((size_t)(dist[v] / rows_.delta) != b || frontier_mark[v] == phase) continue;
+                frontier_mark[v] = phase;
+                frontier.push_back(v);
+                if (!settled_mark[v]) {
+                    settled_mark[v] = 1;
+                    settled.push_back(v);
+                }
+            }
+            ++phase;
+            relax(frontier, true, dist, parent, improved);
+        }
+        relax(settled, false, dist, parent, improved);
+        for (int v : settled) settled_mark[v] = 0;
+    }
+    buckets_.clear();
+    return improved;
+}
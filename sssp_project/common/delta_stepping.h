@@ -0,0 +1,62 @@
+#pragma once
+#include <vector>
+#include "csr_graph.h"
+
+// Rows of graph.localVertices copied out of the graph with light edges (w <= delta)
+// ahead of heavy ones. Rows of other vertices are left empty.
+struct SplitRows {
+    long long delta = 1;
+    std::vector<long long> offsets;   // indexed by graph row
+    std::vector<long long> light_end;
+    std::vector<Edge> edges;
+
+    void build(const CSRGraph& graph, long long delta);
+};
+
+// Largest weight and entry count over the rows of graph.localVertices
+void local_edge_stats(const CSRGraph& graph, int& max_weight, long long& entries);
+// max weight / average degree, at least 1
+long long default_delta(long long max_weight, long long entries, long long vertices);
+
+// Shared-memory delta-stepping (Meyer & Sanders). Tentative distances live in buckets
+// of width delta; a bucket is settled by relaxing the light edges (w <= delta) of its
+// frontier until it stops refilling, then the heavy edges of everything it settled,
+// once. In every phase threads scan frontier rows into per-thread request buffers and
+// then each thread applies the requests for the targets it owns (v % threads), so
+// dist/parent are written without locks or atomics.
+//
+// Only rows of graph.localVertices are expanded. On a partitioned graph a run settles
+// what is reachable through owned rows; distances of other vertices are still lowered,
+// and propagating them further is up to the caller's exchange.
+class DeltaStepping {
+public:
+    // Snapshots the graph's current edges with each row split into light and heavy
+    // parts. delta <= 0 picks max weight / average degree, at least 1.
+    explicit DeltaStepping(const CSRGraph& graph, long long delta = 0);
+
+    long long delta() const { return rows_.delta; }
+
+    // Single-source run; dist/parent are reset to DIST_INF / -1 first
+    long long run(int source, std::vector<long long>& dist, std::vector<int>& parent);
+
+    // Continues from the caller's dist/parent, starting from seeds. Returns the number
+    // of distance improvements made.
+    long long run(const std::vector<int>& seeds, std::vector<long long>& dist, std::vector<int>& parent);
+
+private:
+    struct Request {
+        int v;
+        int parent;
+        long long dist;
+    };
+
+    void relax(const std::vector<int>& frontier, bool light, std::vector<long long>& dist,
+               std::vector<int>& parent, long long& improved);
+
+    const CSRGraph& graph_;
+    SplitRows rows_;
+    int threads_;
+    std::vector<std::vector<std::vector<Request>>> requests_; // [source thread][owner thread]
+    std::vector<std::vector<int>> improved_;                   // per owner thread
+    std::vector<std::vector<int>> buckets_;
+};
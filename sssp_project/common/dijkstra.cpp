@@ -0,0 +1,64 @@
+#include "dijkstra.h"
+#include <algorithm>
+#include "monotone_queue.h"
+
+namespace {
+
+template <class Queue>
+long long run(const CSRGraph& graph, int source, Queue& queue, std::vector<long long>& dist,
+              std::vector<int>& parent) {
+    long long settled = 0;
+    dist[source] = 0;
+    queue.push(source, 0);
+    while (!queue.empty()) {
+        int u = queue.pop();
+        ++settled;
+        int r = graph.row(u);
+        if (r < 0) continue;
+        long long du = dist[u];
+        graph.forEachEdge(r, [&](int v, int w) {
+            if (v < 0 || v >= graph.numVertices() || du + w >= dist[v]) return;
+            dist[v] = du + w;
+            parent[v] = u;
+            queue.push(v, dist[v]);
+        });
+    }
+    return settled;
+}
+
+} // namespace
+
+bool parse_queue_kind(const std::string& name, QueueKind& kind) {
+    if (name == "binary") kind = QueueKind::Binary;
+    else if (name == "radix") kind = QueueKind::Radix;
+    else if (name == "dial") kind = QueueKind::Dial;
+    else return false;
+    return true;
+}
+
+long long dijkstra(const CSRGraph& graph, int source, QueueKind kind, std::vector<long long>& dist,
+                   std::vector<int>& parent) {
+    int n = graph.numVertices();
+    dist.assign(n, DIST_INF);
+    parent.assign(n, -1);
+    if (source < 0 || source >= n) return 0;
+
+    int max_weight = 0;
+    if (kind == QueueKind::Dial) {
+        for (int r = 0; r < graph.numRows(); ++r) {
+            graph.forEachEdge(r, [&](int, int w) { max_weight = std::max(max_weight, w); });
+        }
+        if (max_weight > (1 << 24)) kind = QueueKind::Radix;
+    }
+
+    if (kind == QueueKind::Dial) {
+        BucketQueue queue(n, max_weight);
+        return run(graph, source, queue, dist, parent);
+    }
+    if (kind == QueueKind::Radix) {
+        RadixHeap queue(n);
+        return run(graph, source, queue, dist, parent);
+    }
+    BinaryHeapQueue queue(n);
+    return run(graph, source, queue, dist, parent);
+}
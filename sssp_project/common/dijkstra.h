@@ -0,0 +1,16 @@
+#pragma once
+#include <string>
+#include <vector>
+#include "csr_graph.h"
+
+enum class QueueKind { Binary, Radix, Dial };
+
+// "binary", "radix" or "dial"; false if the name is unknown
+bool parse_queue_kind(const std::string& name, QueueKind& kind);
+
+// Dijkstra from source over the rows this graph holds, with the chosen monotone queue
+// (see monotone_queue.h). Dial needs integer weights up to a modest maximum and falls
+// back to the radix heap above 2^24. dist/parent are reset to DIST_INF / -1 first.
+// Returns the number of vertices settled.
+long long dijkstra(const CSRGraph& graph, int source, QueueKind kind, std::vector<long long>& dist,
+                   std::vector<int>& parent);
@@ -0,0 +1,152 @@
+#include "dist_bfs.h"
+#include <algorithm>
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+#include "bfs.h"
+#include "dist_loader.h"
+
+namespace {
+
+int max_threads() {
+#ifdef _OPENMP
+    return omp_get_max_threads();
+#else
+    return 1;
+#endif
+}
+
+int thread_id() {
+#ifdef _OPENMP
+    return omp_get_thread_num();
+#else
+    return 0;
+#endif
+}
+
+long long row_entries(const CSRGraph& graph, int v) {
+    int r = graph.row(v);
+    return r < 0 ? 0 : graph.rowEnd(r) - graph.rowBegin(r);
+}
+
+} // namespace
+
+DistributedBFS::DistributedBFS(const CSRGraph& graph, MPI_Comm comm)
+    : graph_(graph), comm_(comm), owner_(gather_owners(graph, comm)), front_((graph.numVertices() + 63) / 64, 0) {
+    MPI_Comm_rank(comm, &rank_);
+    MPI_Comm_size(comm, &nprocs_);
+}
+
+void DistributedBFS::topDown(const std::vector<int>& frontier, long long level, std::vector<long long>& dist,
+                             std::vector<int>& parent, std::vector<int>& next) {
+    // Per-thread, per-destination-rank (vertex, parent) pairs
+    int threads = max_threads();
+    std::vector<std::vector<std::vector<int>>> pairs(threads, std::vector<std::vector<int>>(nprocs_));
+    #pragma omp parallel num_threads(threads)
+    {
+        std::vector<std::vector<int>>& out = pairs[thread_id()];
+        #pragma omp for schedule(dynamic, 64)
+        for (size_t i = 0; i < frontier.size(); ++i) {
+            int u = frontier[i];
+            int r = graph_.row(u);
+            if (r < 0) continue;
+            graph_.forEachEdge(r, [&](int v, int) {
+                int o = owner_[v];
+                if (o < 0 || (o == rank_ && dist[v] != DIST_INF)) return;
+                out[o].push_back(v);
+                out[o].push_back(u);
+            });
+        }
+    }
+
+    auto claim = [&](int v, int u) {
+        if (dist[v] == DIST_INF) {
+            dist[v] = level + 1;
+            parent[v] = u;
+            next.push_back(v);
+        } else if (dist[v] == level + 1 && u < parent[v]) {
+            parent[v] = u;
+        }
+    };
+    std::vector<std::vector<int>> out(nprocs_);
+    for (auto& t : pairs) {
+        for (int o = 0; o < nprocs_; ++o) {
+            if (o == rank_) {
+                for (size_t i = 0; i < t[o].size(); i += 2) claim(t[o][i], t[o][i + 1]);
+            } else {
+                out[o].insert(out[o].end(), t[o].begin(), t[o].end());
+                messages_ += t[o].size() / 2;
+            }
+        }
+    }
+    std::vector<int> in = alltoallv(out, comm_);
+    for (size_t i = 0; i < in.size(); i += 2) claim(in[i], in[i + 1]);
+}
+
+void DistributedBFS::bottomUp(const std::vector<int>& frontier, long long level, std::vector<long long>& dist,
+                              std::vector<int>& parent, std::vector<int>& next) {
+    std::fill(front_.begin(), front_.end(), 0);
+    for (int v : frontier) front_[v >> 6] |= 1ULL << (v & 63);
+    MPI_Allreduce(MPI_IN_PLACE, front_.data(), front_.size(), MPI_UINT64_T, MPI_BOR, comm_);
+
+    const std::vector<int>& owned = graph_.localVertices;
+    std::vector<std::vector<int>> found(max_threads());
+    #pragma omp parallel
+    {
+        std::vector<int>& mine = found[thread_id()];
+        #pragma omp for schedule(static, 1024)
+        for (size_t i = 0; i < owned.size(); ++i) {
+            int v = owned[i];
+            int r = graph_.row(v);
+            if (dist[v] != DIST_INF || r < 0) continue;
+            graph_.anyEdge(r, [&](int u, int) {
+                if (!((front_[u >> 6] >> (u & 63)) & 1)) return false;
+                dist[v] = level + 1;
+                parent[v] = u;
+                mine.push_back(v);
+                return true;
+            });
+        }
+    }
+    for (auto& f : found) next.insert(next.end(), f.begin(), f.end());
+}
+
+void DistributedBFS::run(int source, std::vector<long long>& dist, std::vector<int>& parent) {
+    int n = graph_.numVertices();
+    dist.assign(n, DIST_INF);
+    parent.assign(n, -1);
+    levels_ = bottom_up_levels_ = 0;
+    messages_ = 0;
+
+    std::vector<int> frontier, next;
+    if (source >= 0 && source < n && owner_[source] == rank_) {
+        dist[source] = 0;
+        frontier.push_back(source);
+    }
+    long long unexplored = 0;
+    for (int v : graph_.localVertices) {
+        if (dist[v] == DIST_INF) unexplored += row_entries(graph_, v);
+    }
+
+    bool bottom_up = false;
+    for (long long level = 0;; ++level) {
+        // Global frontier size, frontier edges and unexplored edges decide the direction
+        long long counts[3] = {(long long)frontier.size(), 0, unexplored};
+        for (int v : frontier) counts[1] += row_entries(graph_, v);
+        MPI_Allreduce(MPI_IN_PLACE, counts, 3, MPI_LONG_LONG, MPI_SUM, comm_);
+        if (counts[0] == 0) break;
+        if (!bottom_up && counts[1] > counts[2] / BFS_ALPHA) bottom_up = true;
+        else if (bottom_up && counts[0] < n / BFS_BETA) bottom_up = false;
+
+        next.clear();
+        if (bottom_up) {
+            bottomUp(frontier, level, dist, parent, next);
+            ++bottom_up_levels_;
+        } else {
+            topDown(frontier, level, dist, parent, next);
+        }
+        ++levels_;
+        for (int v : next) unexplored -= row_entries(graph_, v);
+        frontier.swap(next);
+    }
+}
@@ -0,0 +1,43 @@
+#pragma once
+#include <cstdint>
+#include <vector>
+#include <mpi.h>
+#include "csr_graph.h"
+
+// Direction-optimizing BFS over a partitioned unit-weight graph. Levels run in lockstep
+// and the direction is picked from global frontier and unexplored edge counts with the
+// same alpha/beta rule as DirectionOptimizingBFS.
+//
+// Top-down: each rank scans its frontier rows and ships (vertex, parent) pairs to the
+// owners, one Alltoallv per level; a vertex reached from several frontier vertices
+// keeps the lowest parent id. Bottom-up: the frontier bitmap is OR-reduced across ranks
+// and each rank lets its own unvisited vertices take the first frontier neighbor in
+// row order, which needs no point-to-point traffic at all.
+class DistributedBFS {
+public:
+    // Collective
+    DistributedBFS(const CSRGraph& graph, MPI_Comm comm);
+
+    // Collective. On return dist/parent are final for the vertices this rank owns and
+    // DIST_INF / -1 everywhere else.
+    void run(int source, std::vector<long long>& dist, std::vector<int>& parent);
+
+    int levels() const { return levels_; }
+    int bottomUpLevels() const { return bottom_up_levels_; }
+    long long messages() const { return messages_; }  // pairs sent to other ranks
+
+private:
+    void topDown(const std::vector<int>& frontier, long long level, std::vector<long long>& dist,
+                 std::vector<int>& parent, std::vector<int>& next);
+    void bottomUp(const std::vector<int>& frontier, long long level, std::vector<long long>& dist,
+                  std::vector<int>& parent, std::vector<int>& next);
+
+    const CSRGraph& graph_;
+    MPI_Comm comm_;
+    int rank_, nprocs_;
+    std::vector<int> owner_;
+    std::vector<uint64_t> front_;
+    int levels_ = 0;
+    int bottom_up_levels_ = 0;
+    long long messages_ = 0;
+};
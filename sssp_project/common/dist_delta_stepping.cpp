@@ -0,0 +1,177 @@
+#include "dist_delta_stepping.h"
+#include <algorithm>
+#include <climits>
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+#include "dist_loader.h"
+
+namespace {
+
+int max_threads() {
+#ifdef _OPENMP
+    return omp_get_max_threads();
+#else
+    return 1;
+#endif
+}
+
+int thread_id() {
+#ifdef _OPENMP
+    return omp_get_thread_num();
+#else
+    return 0;
+#endif
+}
+
+// Exchanges (target, distance, parent) triples; out[r] goes to rank r
+std::vector<long long> exchange_requests(const std::vector<std::vector<long long>>& out, MPI_Comm comm) {
+    int nprocs = out.size();
+    std::vector<int> scounts(nprocs), rcounts(nprocs), sdispls(nprocs, 0), rdispls(nprocs, 0);
+    for (int r = 0; r < nprocs; ++r) scounts[r] = out[r].size();
+    MPI_Alltoall(scounts.data(), 1, MPI_INT, rcounts.data(), 1, MPI_INT, comm);
+    for (int r = 1; r < nprocs; ++r) {
+        sdispls[r] = sdispls[r - 1] + scounts[r - 1];
+        rdispls[r] = rdispls[r - 1] + rcounts[r - 1];
+    }
+    std::vector<long long> sendbuf;
+    sendbuf.reserve(sdispls[nprocs - 1] + scounts[nprocs - 1]);
+    for (const auto& o : out) sendbuf.insert(sendbuf.end(), o.begin(), o.end());
+    std::vector<long long> recvbuf(rdispls[nprocs - 1] + rcounts[nprocs - 1]);
+    MPI_Alltoallv(sendbuf.data(), scounts.data(), sdispls.data(), MPI_LONG_LONG, recvbuf.data(), rcounts.data(),
+                  rdispls.data(), MPI_LONG_LONG, comm);
+    return recvbuf;
+}
+
+} // namespace
+
+DistributedDeltaStepping::DistributedDeltaStepping(const CSRGraph& graph, MPI_Comm comm, long long delta)
+    : graph_(graph), comm_(comm) {
+    MPI_Comm_rank(comm, &rank_);
+    MPI_Comm_size(comm, &nprocs_);
+
+    if (delta <= 0) {
+        int max_weight;
+        long long stats[2];
+        local_edge_stats(graph, max_weight, stats[0]);
+        stats[1] = graph.localVertices.size();
+        MPI_Allreduce(MPI_IN_PLACE, &max_weight, 1, MPI_INT, MPI_MAX, comm);
+        MPI_Allreduce(MPI_IN_PLACE, stats, 2, MPI_LONG_LONG, MPI_SUM, comm);
+        delta = default_delta(max_weight, stats[0], stats[1]);
+    }
+    rows_.build(graph, delta);
+
+    owner_ = gather_owners(graph, comm);
+}
+
+void DistributedDeltaStepping::apply(int v, long long d, int p, std::vector<long long>& dist,
+                                     std::vector<int>& parent) {
+    if (d >= dist[v]) return;
+    dist[v] = d;
+    parent[v] = p;
+    size_t b = d / rows_.delta;
+    if (b >= buckets_.size()) buckets_.resize(b + 1);
+    buckets_[b].push_back(v);
+}
+
+void DistributedDeltaStepping::relax(const std::vector<int>& frontier, bool light, std::vector<long long>& dist,
+                                     std::vector<int>& parent) {
+    // Per-thread, per-destination-rank request triples
+    int threads = max_threads();
+    std::vector<std::vector<std::vector<long long>>> requests(threads, std::vector<std::vector<long long>>(nprocs_));
+    #pragma omp parallel num_threads(threads)
+    {
+        std::vector<std::vector<long long>>& out = requests[thread_id()];
+        #pragma omp for schedule(dynamic, 64)
+        for (size_t i = 0; i < frontier.size(); ++i) {
+            int u = frontier[i];
+            int r = graph_.row(u);
+            if (r < 0) continue;
+            long long du = dist[u];
+            long long begin = light ? rows_.offsets[r] : rows_.light_end[r];
+            long long end = light ? rows_.light_end[r] : rows_.offsets[r + 1];
+            for (long long e = begin; e < end; ++e) {
+                int v = rows_.edges[e].dest;
+                int o = owner_[v];
+                long long nd = du + rows_.edges[e].weight;
+                if (o < 0 || (o == rank_ && nd >= dist[v])) continue;
+                out[o].push_back(v);
+                out[o].push_back(nd);
+                out[o].push_back(u);
+            }
+        }
+    }
+
+    std::vector<std::vector<long long>> out(nprocs_);
+    for (auto& t : requests) {
+        for (int o = 0; o < nprocs_; ++o) {
+            if (o == rank_) {
+                for (size_t i = 0; i < t[o].size(); i += 3) apply(t[o][i], t[o][i + 1], t[o][i + 2], dist, parent);
+            } else {
+                out[o].insert(out[o].end(), t[o].begin(), t[o].end());
+                messages_ += t[o].size() / 3;
+            }
+        }
+    }
+    std::vector<long long> in = exchange_requests(out, comm_);
+    for (size_t i = 0; i < in.size(); i += 3) apply(in[i], in[i + 1], in[i + 2], dist, parent);
+    ++phases_;
+}
+
+void DistributedDeltaStepping::run(int source, std::vector<long long>& dist, std::vector<int>& parent) {
+    int n = graph_.numVertices();
+    dist.assign(n, DIST_INF);
+    parent.assign(n, -1);
+    buckets_.clear();
+    phases_ = 0;
+    messages_ = 0;
+    if (source >= 0 && source < n && owner_[source] == rank_) apply(source, 0, -1, dist, parent);
+
+    std::vector<int> frontier_mark(n, -1);
+    std::vector<char> settled_mark(n, 0);
+    std::vector<int> frontier, settled, pending;
+    int phase = 0;
+    size_t cursor = 0;
+    while (true) {
+        // Drop stale entries so an emptied bucket does not hold up the global minimum
+        while (cursor < buckets_.size()) {
+            auto& bucket = buckets_[cursor];
+            bucket.erase(std::remove_if(bucket.begin(), bucket.end(),
+                                        [&](int v) { return (size_t)(dist[v] / rows_.delta) != cursor; }),
+                         bucket.end());
+            if (!bucket.empty()) break;
+            ++cursor;
+        }
+        long long b = cursor < buckets_.size() ? (long long)cursor : LLONG_MAX;
+        MPI_Allreduce(MPI_IN_PLACE, &b, 1, MPI_LONG_LONG, MPI_MIN, comm_);
+        if (b == LLONG_MAX) break;
+        cursor = b;
+        if (cursor >= buckets_.size()) buckets_.resize(cursor + 1);
+
+        // Light phases until no rank refills bucket b, then one heavy phase
+        settled.clear();
+        int more = 1;
+        while (more) {
+            pending.clear();
+            pending.swap(buckets_[cursor]);
+            frontier.clear();
+            for (int v : pending) {
+                if ((size_t)(dist[v] / rows_.delta) != cursor || frontier_mark[v] == phase) continue;
+                frontier_mark[v] = phase;
+                frontier.push_back(v);
+                if (!settled_mark[v]) {
+                    settled_mark[v] = 1;
+                    settled.push_back(v);
+                }
+            }
+            ++phase;
+            relax(frontier, true, dist, parent);
+            more = !buckets_[cursor].empty();
+            MPI_Allreduce(MPI_IN_PLACE, &more, 1, MPI_INT, MPI_LOR, comm_);
+        }
+        relax(settled, false, dist, parent);
+        for (int v : settled) settled_mark[v] = 0;
+        ++cursor;
+    }
+    buckets_.clear();
+}
@@ -0,0 +1,41 @@
+#pragma once
+#include <vector>
+#include <mpi.h>
+#include "csr_graph.h"
+#include "delta_stepping.h"
+
+// Distributed delta-stepping over a partitioned graph. Each rank relaxes the edges of
+// its own rows; a relaxation whose target another rank owns becomes a
+// (target, distance, parent) message to that owner, and messages are exchanged with
+// one Alltoallv per phase. Buckets advance in lockstep: the bucket processed next is
+// the minimum non-empty bucket over all ranks. Within a rank, frontier rows are
+// scanned in parallel when built with OpenMP.
+class DistributedDeltaStepping {
+public:
+    // Collective. delta <= 0 derives one delta for all ranks from global edge stats.
+    DistributedDeltaStepping(const CSRGraph& graph, MPI_Comm comm, long long delta = 0);
+
+    long long delta() const { return rows_.delta; }
+    int owner(int v) const { return owner_[v]; }
+
+    // Collective. On return dist/parent are final for the vertices this rank owns and
+    // DIST_INF / -1 everywhere else.
+    void run(int source, std::vector<long long>& dist, std::vector<int>& parent);
+
+    int phases() const { return phases_; }
+    long long messages() const { return messages_; }  // relaxations sent to other ranks
+
+private:
+    void relax(const std::vector<int>& frontier, bool light, std::vector<long long>& dist,
+               std::vector<int>& parent);
+    void apply(int v, long long d, int p, std::vector<long long>& dist, std::vector<int>& parent);
+
+    const CSRGraph& graph_;
+    MPI_Comm comm_;
+    int rank_, nprocs_;
+    SplitRows rows_;
+    std::vector<int> owner_;
+    std::vector<std::vector<int>> buckets_;
+    int phases_ = 0;
+    long long messages_ = 0;
+};
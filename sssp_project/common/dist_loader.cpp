@@ -0,0 +1,411 @@
+#include "dist_loader.h"
+#include <algorithm>
+#include <cstring>
+#include <iostream>
+#include <vector>
+#include "graph_io.h"
+#include "text_parser.h"
+
+namespace {
+
+void read_bytes(MPI_File fh, MPI_Offset at, void* buf, size_t len) {
+    char* p = static_cast<char*>(buf);
+    while (len > 0) {
+        int chunk = (int)std::min<size_t>(len, 1 << 30);
+        MPI_File_read_at(fh, at, p, chunk, MPI_BYTE, MPI_STATUS_IGNORE);
+        at += chunk;
+        p += chunk;
+        len -= chunk;
+    }
+}
+
+// First line start at or after pos, so neighbouring ranks agree on the split
+MPI_Offset next_line_start(MPI_File fh, MPI_Offset pos, MPI_Offset begin, MPI_Offset size) {
+    if (pos <= begin) return begin;
+    if (pos >= size) return size;
+    char buf[4096];
+    MPI_Offset at = pos - 1;
+    while (at < size) {
+        size_t len = std::min<MPI_Offset>(sizeof(buf), size - at);
+        read_bytes(fh, at, buf, len);
+        const char* nl = static_cast<const char*>(std::memchr(buf, '\n', len));
+        if (nl) return at + (nl - buf) + 1;
+        at += len;
+    }
+    return size;
+}
+
+// The complete lines whose first byte lies in this rank's share of [begin, size)
+std::string read_line_block(MPI_File fh, MPI_Offset begin, int rank, int nprocs) {
+    MPI_Offset size;
+    MPI_File_get_size(fh, &size);
+    MPI_Offset len = size - begin;
+    MPI_Offset start = next_line_start(fh, begin + len * rank / nprocs, begin, size);
+    MPI_Offset end = next_line_start(fh, begin + len * (rank + 1) / nprocs, begin, size);
+    std::string block(std::max<MPI_Offset>(end - start, 0), '\0');
+    read_bytes(fh, start, &block[0], block.size());
+    return block;
+}
+
+template <class F>
+void for_each_line(const std::string& block, F&& f) {
+    const char* p = block.data();
+    const char* end = p + block.size();
+    while (p < end) {
+        const char* le = line_end(p, end);
+        if (*p != '%') f(p, le);
+        p = le + 1;
+    }
+}
+
+// Owner entries for the contiguous vertex range [lo, lo + owners.size())
+struct PartitionBlock {
+    long long lo = 0;
+    std::vector<int> owners;
+};
+
+bool read_text_partition(const std::string& partFile, MPI_Comm comm, PartitionBlock& block) {
+    int rank, nprocs;
+    MPI_Comm_rank(comm, &rank);
+    MPI_Comm_size(comm, &nprocs);
+    MPI_File fh;
+    if (MPI_File_open(comm, partFile.c_str(), MPI_MODE_RDONLY, MPI_INFO_NULL, &fh) != MPI_SUCCESS) {
+        if (rank == 0) std::cerr << "Error opening partition file " << partFile << "\n";
+        return false;
+    }
+    std::string lines = read_line_block(fh, 0, rank, nprocs);
+    MPI_File_close(&fh);
+
+    block.owners.clear();
+    for_each_line(lines, [&](const char* p, const char* le) {
+        long long part;
+        if (next_int(p, le, part)) block.owners.push_back(part);
+    });
+    long long count = block.owners.size();
+    block.lo = 0;
+    MPI_Exscan(&count, &block.lo, 1, MPI_LONG_LONG, MPI_SUM, comm);
+    if (rank == 0) block.lo = 0;
+    return true;
+}
+
+// Rank 0 streams the whole graph file once and scatters |V|/p-sized blocks of the result
+bool stream_partition_block(const std::string& graphFile, const PartitionSpec& spec, MPI_Comm comm,
+                            PartitionBlock& block) {
+    int rank, nprocs;
+    MPI_Comm_rank(comm, &rank);
+    MPI_Comm_size(comm, &nprocs);
+    std::vector<int> part;
+    PartitionStats stats;
+    long long n = -1;
+    if (rank == 0 && stream_partition_file(graphFile, nprocs, spec.method, spec.slack, part, &stats)) {
+        n = part.size();
+        print_partition_stats(stats);
+    }
+    MPI_Bcast(&n, 1, MPI_LONG_LONG, 0, comm);
+    if (n < 0) return false;
+
+    std::vector<int> counts(nprocs), displs(nprocs);
+    for (int r = 0; r < nprocs; ++r) {
+        displs[r] = n * r / nprocs;
+        counts[r] = n * (r + 1) / nprocs - displs[r];
+    }
+    block.lo = displs[rank];
+    block.owners.resize(counts[rank]);
+    MPI_Scatterv(part.data(), counts.data(), displs.data(), MPI_INT, block.owners.data(), counts[rank], MPI_INT, 0,
+                 comm);
+    return true;
+}
+
+bool load_binary(const std::string& graphFile, const PartitionSpec& spec, MPI_Comm comm, CSRGraph& graph) {
+    int rank, nprocs;
+    MPI_Comm_rank(comm, &rank);
+    MPI_Comm_size(comm, &nprocs);
+    MPI_File fh;
+    if (MPI_File_open(comm, graphFile.c_str(), MPI_MODE_RDONLY, MPI_INFO_NULL, &fh) != MPI_SUCCESS) {
+        if (rank == 0) std::cerr << "Error opening graph file " << graphFile << "\n";
+        return false;
+    }
+
+    BinaryGraphHeader h;
+    if (rank == 0) read_bytes(fh, 0, &h, sizeof(h));
+    MPI_Bcast(&h, sizeof(h), MPI_BYTE, 0, comm);
+    long long n = h.num_vertices;
+
+    // Partition block [lo, hi) of every rank
+    PartitionBlock block;
+    bool ok = true;
+    if (!spec.file.empty()) {
+        ok = read_text_partition(spec.file, comm, block);
+    } else if ((h.flags & GRAPH_HAS_PARTITION) && h.num_parts == (uint32_t)nprocs) {
+        block.lo = n * rank / nprocs;
+        block.owners.resize(n * (rank + 1) / nprocs - block.lo);
+        read_bytes(fh, h.partition_pos + block.lo * sizeof(int32_t), block.owners.data(),
+                   block.owners.size() * sizeof(int32_t));
+    } else {
+        ok = stream_partition_block(graphFile, spec, comm, block);
+    }
+    if (!ok) {
+        MPI_File_close(&fh);
+        return false;
+    }
+
+    long long covered = block.owners.size();
+    MPI_Allreduce(MPI_IN_PLACE, &covered, 1, MPI_LONG_LONG, MPI_SUM, comm);
+    if (covered < n) {
+        if (rank == 0) std::cerr << "Partition covers " << covered << " of " << n << " vertices\n";
+        MPI_File_close(&fh);
+        return false;
+    }
+
+    // Single ownership exchange: every vertex id is sent to its owner
+    std::vector<std::vector<int>> out(nprocs);
+    bool bad_part = false;
+    for (size_t i = 0; i < block.owners.size() && block.lo + (long long)i < n; ++i) {
+        int p = block.owners[i];
+        if (p < 0 || p >= nprocs) {
+            bad_part = true;
+            continue;
+        }
+        out[p].push_back(block.lo + i);
+    }
+    int any_bad = bad_part;
+    MPI_Allreduce(MPI_IN_PLACE, &any_bad, 1, MPI_INT, MPI_LOR, comm);
+    if (any_bad) {
+        if (rank == 0) std::cerr << "Partition refers to more parts than the " << nprocs << " ranks\n";
+        MPI_File_close(&fh);
+        return false;
+    }
+    std::vector<int> owned = alltoallv(out, comm);
+
+    // Offsets and neighbor ranges of owned vertices, one read per run of consecutive ids
+    std::vector<long long> offsets(1, 0);
+    std::vector<int> adj, wts;
+    bool weighted = h.flags & GRAPH_HAS_WEIGHTS;
+    for (size_t i = 0; i < owned.size();) {
+        size_t j = i + 1;
+        while (j < owned.size() && owned[j] == owned[j - 1] + 1) ++j;
+        std::vector<int64_t> run(j - i + 1);
+        read_bytes(fh, h.offsets_pos + (MPI_Offset)owned[i] * sizeof(int64_t), run.data(), run.size() * sizeof(int64_t));
+        size_t base = adj.size();
+        adj.resize(base + (run.back() - run.front()));
+        read_bytes(fh, h.neighbors_pos + run.front() * sizeof(int32_t), adj.data() + base,
+                   (adj.size() - base) * sizeof(int32_t));
+        if (weighted) {
+            wts.resize(adj.size());
+            read_bytes(fh, h.weights_pos + run.front() * sizeof(int32_t), wts.data() + base,
+                       (wts.size() - base) * sizeof(int32_t));
+        }
+        for (size_t k = 1; k < run.size(); ++k) offsets.push_back(base + (run[k] - run.front()));
+        i = j;
+    }
+    MPI_File_close(&fh);
+
+    graph = CSRGraph::fromRows(n, std::move(owned), std::move(offsets), std::move(adj), std::move(wts));
+    return true;
+}
+
+bool load_metis(const std::string& graphFile, const PartitionSpec& spec, MPI_Comm comm, CSRGraph& graph) {
+    int rank, nprocs;
+    MPI_Comm_rank(comm, &rank);
+    MPI_Comm_size(comm, &nprocs);
+    MPI_File fh;
+    if (MPI_File_open(comm, graphFile.c_str(), MPI_MODE_RDONLY, MPI_INFO_NULL, &fh) != MPI_SUCCESS) {
+        if (rank == 0) std::cerr << "Error opening graph file " << graphFile << "\n";
+        return false;
+    }
+    std::string lines = read_line_block(fh, 0, rank, nprocs);
+    MPI_File_close(&fh);
+
+    // Rows parsed here cover lines [first, first + count); line 0 is the header
+    std::vector<std::vector<int>> rows;
+    long long header_n = 0;
+    for_each_line(lines, [&](const char* p, const char* le) {
+        rows.emplace_back();
+        long long x;
+        while (next_int(p, le, x)) rows.back().push_back(x);
+    });
+    long long count = rows.size(), first = 0;
+    MPI_Exscan(&count, &first, 1, MPI_LONG_LONG, MPI_SUM, comm);
+    if (rank == 0) {
+        first = 0;
+        if (!rows.empty() && !rows[0].empty()) header_n = rows[0][0];
+    }
+    MPI_Bcast(&header_n, 1, MPI_LONG_LONG, 0, comm);
+    long long n = header_n;
+
+    // Vertex range [a, b) of the adjacency rows parsed by this rank
+    long long skip = (rank == 0 && !rows.empty()) ? 1 : 0;
+    long long a = std::min(std::max(first - 1 + skip, 0LL), n);
+    long long b = std::min(first - 1 + count, n);
+    if (b < a) b = a;
+
+    PartitionBlock block;
+    if (spec.file.empty() ? !stream_partition_block(graphFile, spec, comm, block)
+                          : !read_text_partition(spec.file, comm, block)) {
+        return false;
+    }
+
+    long long ranges[4] = {a, b, block.lo, block.lo + (long long)block.owners.size()};
+    std::vector<long long> all(4 * nprocs);
+    MPI_Allgather(ranges, 4, MPI_LONG_LONG, all.data(), 4, MPI_LONG_LONG, comm);
+
+    // Owners of my rows come from whichever partition blocks overlap [a, b)
+    std::vector<std::vector<int>> out(nprocs);
+    for (int r = 0; r < nprocs; ++r) {
+        long long lo = std::max(all[4 * r], block.lo);
+        long long hi = std::min(all[4 * r + 1], block.lo + (long long)block.owners.size());
+        for (long long v = lo; v < hi; ++v) out[r].push_back(block.owners[v - block.lo]);
+    }
+    std::vector<int> owners = alltoallv(out, comm);
+    int short_part = (long long)owners.size() != b - a;
+    MPI_Allreduce(MPI_IN_PLACE, &short_part, 1, MPI_INT, MPI_LOR, comm);
+    if (short_part) {
+        if (rank == 0) std::cerr << "Partition does not cover all " << n << " vertices\n";
+        return false;
+    }
+
+    // Ship each row as [vertex, degree, neighbors...] to its owner
+    for (auto& o : out) o.clear();
+    bool bad_part = false;
+    for (long long v = a; v < b; ++v) {
+        int p = owners[v - a];
+        if (p < 0 || p >= nprocs) {
+            bad_part = true;
+            continue;
+        }
+        std::vector<int>& row = rows[v - first + 1];
+        for (int& x : row) --x; // METIS is 1-based
+        row.erase(std::remove_if(row.begin(), row.end(), [&](int x) { return x < 0 || x >= n || x == v; }), row.end());
+        std::sort(row.begin(), row.end());
+        row.erase(std::unique(row.begin(), row.end()), row.end());
+        out[p].push_back(v);
+        out[p].push_back(row.size());
+        out[p].insert(out[p].end(), row.begin(), row.end());
+        std::vector<int>().swap(row);
+    }
+    int any_bad = bad_part;
+    MPI_Allreduce(MPI_IN_PLACE, &any_bad, 1, MPI_INT, MPI_LOR, comm);
+    if (any_bad) {
+        if (rank == 0) std::cerr << "Partition refers to more parts than the " << nprocs << " ranks\n";
+        return false;
+    }
+    std::vector<int> recv = alltoallv(out, comm);
+
+    // Rows arrive grouped by sender; senders hold ascending vertex ranges, so the
+    // concatenation is already sorted by vertex id
+    std::vector<int> owned;
+    std::vector<long long> offsets(1, 0);
+    std::vector<int> adj;
+    for (size_t i = 0; i < recv.size();) {
+        owned.push_back(recv[i]);
+        int deg = recv[i + 1];
+        adj.insert(adj.end(), recv.begin() + i + 2, recv.begin() + i + 2 + deg);
+        offsets.push_back(adj.size());
+        i += 2 + deg;
+    }
+    graph = CSRGraph::fromRows(n, std::move(owned), std::move(offsets), std::move(adj), {});
+    return true;
+}
+
+} // namespace
+
+bool load_distributed_graph(const std::string& graphFile, const PartitionSpec& spec, MPI_Comm comm,
+                            CSRGraph& graph) {
+    bool ok = is_binary_graph(graphFile) ? load_binary(graphFile, spec, comm, graph)
+                                         : load_metis(graphFile, spec, comm, graph);
+    int all_ok = ok;
+    MPI_Allreduce(MPI_IN_PLACE, &all_ok, 1, MPI_INT, MPI_LAND, comm);
+    return all_ok;
+}
+
+std::vector<int> gather_owners(const CSRGraph& graph, MPI_Comm comm) {
+    int nprocs;
+    MPI_Comm_size(comm, &nprocs);
+    int count = graph.localVertices.size();
+    std::vector<int> counts(nprocs), displs(nprocs, 0);
+    MPI_Allgather(&count, 1, MPI_INT, counts.data(), 1, MPI_INT, comm);
+    for (int r = 1; r < nprocs; ++r) displs[r] = displs[r - 1] + counts[r - 1];
+    std::vector<int> all(displs[nprocs - 1] + counts[nprocs - 1]);
+    MPI_Allgatherv(graph.localVertices.data(), count, MPI_INT, all.data(), counts.data(), displs.data(), MPI_INT,
+                   comm);
+    std::vector<int> owner(graph.numVertices(), -1);
+    for (int r = 0; r < nprocs; ++r) {
+        for (int i = displs[r]; i < displs[r] + counts[r]; ++i) owner[all[i]] = r;
+    }
+    return owner;
+}
+
+std::vector<int> alltoallv(const std::vector<std::vector<int>>& out, MPI_Comm comm) {
+    int nprocs = out.size();
+    std::vector<int> scounts(nprocs), rcounts(nprocs), sdispls(nprocs, 0), rdispls(nprocs, 0);
+    for (int r = 0; r < nprocs; ++r) scounts[r] = out[r].size();
+    MPI_Alltoall(scounts.data(), 1, MPI_INT, rcounts.data(), 1, MPI_INT, comm);
+    for (int r = 1; r < nprocs; ++r) {
+        sdispls[r] = sdispls[r - 1] + scounts[r - 1];
+        rdispls[r] = rdispls[r - 1] + rcounts[r - 1];
+    }
+    std::vector<int> sendbuf;
+    sendbuf.reserve(sdispls[nprocs - 1] + scounts[nprocs - 1]);
+    for (const auto& o : out) sendbuf.insert(sendbuf.end(), o.begin(), o.end());
+    std::vector<int> recvbuf(rdispls[nprocs - 1] + rcounts[nprocs - 1]);
+    MPI_Alltoallv(sendbuf.data(), scounts.data(), sdispls.data(), MPI_INT, recvbuf.data(), rcounts.data(),
+                  rdispls.data(), MPI_INT, comm);
+    return recvbuf;
+}
+
+std::vector<int> allgatherv(const std::vector<int>& local, MPI_Comm comm) {
+    int nprocs;
+    MPI_Comm_size(comm, &nprocs);
+    int count = local.size();
+    std::vector<int> counts(nprocs), displs(nprocs, 0);
+    MPI_Allgather(&count, 1, MPI_INT, counts.data(), 1, MPI_INT, comm);
+    for (int r = 1; r < nprocs; ++r) displs[r] = displs[r - 1] + counts[r - 1];
+    std::vector<int> all(displs[nprocs - 1] + counts[nprocs - 1]);
+    MPI_Allgatherv(local.data(), count, MPI_INT, all.data(), counts.data(), displs.data(), MPI_INT, comm);
+    return all;
+}
+
+long long take_owned_flags(int num_owned, std::vector<int>& flags, Frontier& frontier, MPI_Comm comm) {
+    frontier.clear();
+    for (int v = 0; v < num_owned; ++v) {
+        if (flags[v]) frontier.insert(v);
+    }
+    std::fill(flags.begin(), flags.end(), 0);
+    long long total = frontier.size();
+    MPI_Allreduce(MPI_IN_PLACE, &total, 1, MPI_LONG_LONG, MPI_SUM, comm);
+    return total;
+}
+
+std::vector<EdgeUpdate> allgather_updates(const std::vector<EdgeUpdate>& local, MPI_Comm comm) {
+    std::vector<int> raw;
+    raw.reserve(local.size() * 4);
+    for (const EdgeUpdate& e : local) raw.insert(raw.end(), {static_cast<int>(e.kind), e.u, e.v, e.w});
+    raw = allgatherv(raw, comm);
+    std::vector<EdgeUpdate> all(raw.size() / 4);
+    for (size_t i = 0; i < all.size(); ++i) {
+        all[i] = {static_cast<UpdateKind>(raw[i * 4]), raw[i * 4 + 1], raw[i * 4 + 2], raw[i * 4 + 3]};
+    }
+    return all;
+}
+
+void broadcast_updates(std::vector<EdgeUpdate>& batch, int root, MPI_Comm comm) {
+    int rank;
+    MPI_Comm_rank(comm, &rank);
+    int count = batch.size();
+    MPI_Bcast(&count, 1, MPI_INT, root, comm);
+    std::vector<int> raw(count * 4);
+    if (rank == root) {
+        for (int i = 0; i < count; ++i) {
+            const EdgeUpdate& e = batch[i];
+            raw[i * 4] = static_cast<int>(e.kind);
+            raw[i * 4 + 1] = e.u;
+            raw[i * 4 + 2] = e.v;
+            raw[i * 4 + 3] = e.w;
+        }
+    }
+    MPI_Bcast(raw.data(), raw.size(), MPI_INT, root, comm);
+    batch.resize(count);
+    for (int i = 0; i < count; ++i) {
+        batch[i] = {static_cast<UpdateKind>(raw[i * 4]), raw[i * 4 + 1], raw[i * 4 + 2], raw[i * 4 + 3]};
+    }
+}
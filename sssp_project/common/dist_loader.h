@@ -0,0 +1,47 @@
+#pragma once
+#include <string>
+#include <vector>
+#include <mpi.h>
+#include "csr_graph.h"
+#include "frontier.h"
+#include "partitioner.h"
+#include "update_stream.h"
+
+// Collective over comm. Every rank reads only its share of the graph and partition
+// files with MPI-IO and ends up holding the CSR rows of exactly the vertices it owns
+// (ascending global id); neighbor ids stay global.
+//
+// The partition comes from spec.file, else from a binary file's embedded partition if
+// it was written for exactly p parts, else rank 0 streams the graph through the
+// LDG/Fennel partitioner and scatters the result. Either way each rank ends up with
+// a block of |V|/p entries.
+//
+// Binary graphs: ownership is exchanged with one Alltoallv, then each rank reads the
+// offset-table and neighbor ranges of its own vertices.
+// METIS text: each rank parses the lines starting in its byte range and ships the
+// rows to their owners. METIS files are already symmetric, so rows are only
+// deduplicated, not symmetrized.
+bool load_distributed_graph(const std::string& graphFile, const PartitionSpec& spec, MPI_Comm comm,
+                            CSRGraph& graph);
+
+// Collective. Owning rank of every vertex (-1 if nobody holds it), gathered from
+// every rank's localVertices.
+std::vector<int> gather_owners(const CSRGraph& graph, MPI_Comm comm);
+
+// Collective. Exchanges variable-length int payloads: out[r] goes to rank r, and the
+// result is ordered by source rank.
+std::vector<int> alltoallv(const std::vector<std::vector<int>>& out, MPI_Comm comm);
+
+// Collective. Concatenation of every rank's local payload, ordered by rank.
+std::vector<int> allgatherv(const std::vector<int>& local, MPI_Comm comm);
+
+// Collective. Loads the raised flags of the owned vertices, local ids below num_owned
+// (see vertex_map.h), into frontier and zeroes flags. Returns the frontier size summed
+// over all ranks.
+long long take_owned_flags(int num_owned, std::vector<int>& flags, Frontier& frontier, MPI_Comm comm);
+
+// Collective. Every rank's update records, concatenated in rank order
+std::vector<EdgeUpdate> allgather_updates(const std::vector<EdgeUpdate>& local, MPI_Comm comm);
+
+// Collective. Replaces batch on every rank with root's
+void broadcast_updates(std::vector<EdgeUpdate>& batch, int root, MPI_Comm comm);
@@ -0,0 +1,98 @@
+#include "distance_store.h"
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <random>
+
+namespace {
+
+// Page p of the arrays, padded with unreachable vertices past the end
+std::shared_ptr<DistancePage> copy_page(const std::vector<long long>& dist, const std::vector<int>& parent,
+                                        size_t p) {
+    auto page = std::make_shared<DistancePage>();
+    size_t begin = p << DIST_PAGE_SHIFT;
+    size_t count = std::min<size_t>(DIST_PAGE_SIZE, dist.size() - begin);
+    std::copy_n(dist.begin() + begin, count, page->dist);
+    std::copy_n(parent.begin() + begin, count, page->parent);
+    std::fill(page->dist + count, page->dist + DIST_PAGE_SIZE, DIST_INF);
+    std::fill(page->parent + count, page->parent + DIST_PAGE_SIZE, -1);
+    return page;
+}
+
+bool page_matches(const DistancePage& page, const std::vector<long long>& dist, const std::vector<int>& parent,
+                  size_t p) {
+    size_t begin = p << DIST_PAGE_SHIFT;
+    size_t count = std::min<size_t>(DIST_PAGE_SIZE, dist.size() - begin);
+    return std::memcmp(page.dist, dist.data() + begin, count * sizeof(long long)) == 0 &&
+           std::memcmp(page.parent, parent.data() + begin, count * sizeof(int)) == 0;
+}
+
+} // namespace
+
+void VersionedDistances::reset(const std::vector<long long>& dist, const std::vector<int>& parent) {
+    auto snap = std::make_shared<DistanceSnapshot>();
+    snap->num_vertices_ = dist.size();
+    snap->pages_.resize((dist.size() + DIST_PAGE_SIZE - 1) >> DIST_PAGE_SHIFT);
+    for (size_t p = 0; p < snap->pages_.size(); ++p) snap->pages_[p] = copy_page(dist, parent, p);
+    std::atomic_store(&current_, std::shared_ptr<const DistanceSnapshot>(std::move(snap)));
+}
+
+size_t VersionedDistances::commit(const std::vector<long long>& dist, const std::vector<int>& parent) {
+    std::shared_ptr<const DistanceSnapshot> last = snapshot();
+    auto snap = std::make_shared<DistanceSnapshot>(*last);
+    snap->epoch_ = last->epoch_ + 1;
+    // Arrays that grew (an MPI rank that gained ghosts) get their new pages copied
+    snap->num_vertices_ = dist.size();
+    snap->pages_.resize((dist.size() + DIST_PAGE_SIZE - 1) >> DIST_PAGE_SHIFT);
+    long long copied = 0;
+    #pragma omp parallel for schedule(static) reduction(+ : copied)
+    for (size_t p = 0; p < snap->pages_.size(); ++p) {
+        if (snap->pages_[p] && page_matches(*snap->pages_[p], dist, parent, p)) continue;
+        snap->pages_[p] = copy_page(dist, parent, p);
+        ++copied;
+    }
+    std::atomic_store(&current_, std::shared_ptr<const DistanceSnapshot>(std::move(snap)));
+    return copied;
+}
+
+SnapshotReaders::SnapshotReaders(const VersionedDistances& store, int threads, uint64_t seed)
+    : store_(store), stats_(std::max(threads, 0)) {
+    for (int t = 0; t < threads; ++t) threads_.emplace_back(&SnapshotReaders::run, this, t, seed + t);
+}
+
+void SnapshotReaders::run(int id, uint64_t seed) {
+    std::mt19937_64 rng(seed);
+    Local& local = stats_[id];
+    local.first_epoch = store_.snapshot()->epoch();
+    while (!done_.load(std::memory_order_relaxed)) {
+        auto start = std::chrono::steady_clock::now();
+        std::shared_ptr<const DistanceSnapshot> snap = store_.snapshot();
+        int n = snap->numVertices();
+        if (n == 0) break;
+        // Parent chains of a committed tree end at the source, or on an MPI rank at a ghost
+        // whose parent it does not hold; the step cap only guards stale parents
+        int v = std::uniform_int_distribution<int>(0, n - 1)(rng);
+        for (int steps = 0; v >= 0 && steps < n && snap->dist(v) != DIST_INF; ++steps) v = snap->parent(v);
+        double us = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+        ++local.queries;
+        local.total_us += us;
+        local.max_us = std::max(local.max_us, us);
+        local.last_epoch = snap->epoch();
+    }
+}
+
+ReadStats SnapshotReaders::stop() {
+    done_ = true;
+    for (auto& t : threads_) t.join();
+    threads_.clear();
+    ReadStats stats;
+    double total = 0;
+    for (const Local& local : stats_) {
+        stats.queries += local.queries;
+        total += local.total_us;
+        stats.max_us = std::max(stats.max_us, local.max_us);
+        if (local.queries) stats.epochs = std::max(stats.epochs, local.last_epoch - local.first_epoch + 1);
+    }
+    if (stats.queries) stats.mean_us = total / stats.queries;
+    return stats;
+}
@@ -0,0 +1,81 @@
+#pragma once
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <thread>
+#include <vector>
+#include "csr_graph.h"
+
+// Vertices per page of a distance snapshot
+const int DIST_PAGE_SHIFT = 10;
+const int DIST_PAGE_SIZE = 1 << DIST_PAGE_SHIFT;
+
+struct DistancePage {
+    long long dist[DIST_PAGE_SIZE];
+    int parent[DIST_PAGE_SIZE];
+};
+
+// Immutable distances and parents of one committed epoch
+class DistanceSnapshot {
+public:
+    uint64_t epoch() const { return epoch_; }
+    int numVertices() const { return num_vertices_; }
+    long long dist(int v) const { return pages_[v >> DIST_PAGE_SHIFT]->dist[v & (DIST_PAGE_SIZE - 1)]; }
+    int parent(int v) const { return pages_[v >> DIST_PAGE_SHIFT]->parent[v & (DIST_PAGE_SIZE - 1)]; }
+
+private:
+    friend class VersionedDistances;
+    uint64_t epoch_ = 0;
+    int num_vertices_ = 0;
+    std::vector<std::shared_ptr<const DistancePage>> pages_;
+};
+
+// Distance store that lets queries run while an update batch is applied. The update
+// kernels keep mutating the driver's Dist/Parent arrays in place; readers only ever see
+// the snapshot of the last commit. commit() copies the pages that differ from that
+// snapshot, shares the rest with it, and publishes the result with one atomic pointer
+// swap, which is the epoch flip. A snapshot stays alive as long as a reader holds it.
+//
+// One writer calls reset/commit; snapshot() may be called from any thread.
+class VersionedDistances {
+public:
+    // Epoch 0
+    void reset(const std::vector<long long>& dist, const std::vector<int>& parent);
+    // Publishes the arrays as the next epoch; returns the number of pages copied
+    size_t commit(const std::vector<long long>& dist, const std::vector<int>& parent);
+
+    std::shared_ptr<const DistanceSnapshot> snapshot() const { return std::atomic_load(&current_); }
+
+private:
+    std::shared_ptr<const DistanceSnapshot> current_;
+};
+
+struct ReadStats {
+    long long queries = 0;
+    double mean_us = 0;
+    double max_us = 0;
+    uint64_t epochs = 0;  // most epochs one reader moved through
+};
+
+// Query load for measuring read latency during updates: each thread takes the current
+// snapshot, picks a random vertex and walks its parent chain to the source, until stop().
+class SnapshotReaders {
+public:
+    SnapshotReaders(const VersionedDistances& store, int threads, uint64_t seed = 1);
+    ~SnapshotReaders() { stop(); }
+
+    ReadStats stop();
+
+private:
+    struct alignas(64) Local {
+        long long queries = 0;
+        double total_us = 0, max_us = 0;
+        uint64_t first_epoch = 0, last_epoch = 0;
+    };
+    void run(int id, uint64_t seed);
+
+    const VersionedDistances& store_;
+    std::atomic<bool> done_{false};
+    std::vector<std::thread> threads_;
+    std::vector<Local> stats_;
+};
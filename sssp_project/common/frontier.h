@@ -0,0 +1,92 @@
+#pragma once
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+// A frontier holding more than 1/FRONTIER_DENSE_RATIO of the vertices stops keeping a
+// list and is walked through its bitmap instead
+const int FRONTIER_DENSE_RATIO = 32;
+
+// Worklist of distinct vertices for the dynamic-update repair loops. Small frontiers are a
+// list plus a membership bitmap, so inserting, walking and clearing cost the number of
+// vertices in it rather than |V|. A large one drops the list and forEach scans the bitmap
+// 64 vertices per word, in vertex order instead of insertion order.
+class Frontier {
+public:
+    explicit Frontier(int num_vertices = 0) { reset(num_vertices); }
+
+    void reset(int num_vertices) {
+        num_vertices_ = num_vertices;
+        bits_.assign((num_vertices + 63) / 64, 0);
+        list_.clear();
+        size_ = 0;
+        dense_ = false;
+    }
+
+    int numVertices() const { return num_vertices_; }
+    bool empty() const { return size_ == 0; }
+    long long size() const { return size_; }
+    bool dense() const { return dense_; }
+    bool contains(int v) const { return bits_[v >> 6] >> (v & 63) & 1; }
+
+    // False if v already is in the frontier
+    bool insert(int v) {
+        uint64_t bit = uint64_t(1) << (v & 63);
+        if (bits_[v >> 6] & bit) return false;
+        bits_[v >> 6] |= bit;
+        ++size_;
+        if (!dense_) {
+            if (size_ * FRONTIER_DENSE_RATIO > num_vertices_) {
+                dense_ = true;
+                list_.clear();
+            } else {
+                list_.push_back(v);
+            }
+        }
+        return true;
+    }
+
+    void clear() {
+        if (dense_) std::fill(bits_.begin(), bits_.end(), 0);
+        else for (int v : list_) bits_[v >> 6] = 0;
+        list_.clear();
+        size_ = 0;
+        dense_ = false;
+    }
+
+    // The vertices in the frontier; f must not insert into this frontier
+    template <class F>
+    void forEach(F f) const {
+        if (!dense_) {
+            for (int v : list_) f(v);
+            return;
+        }
+        for (size_t i = 0; i < bits_.size(); ++i) {
+            for (uint64_t word = bits_[i]; word; word &= word - 1) {
+                f(int(i * 64 + __builtin_ctzll(word)));
+            }
+        }
+    }
+
+    // The vertices as a list, for loops that split the frontier among threads
+    void toVector(std::vector<int>& out) const {
+        out.clear();
+        out.reserve(size_);
+        forEach([&](int v) { out.push_back(v); });
+    }
+
+    void swap(Frontier& other) {
+        std::swap(num_vertices_, other.num_vertices_);
+        bits_.swap(other.bits_);
+        list_.swap(other.list_);
+        std::swap(size_, other.size_);
+        std::swap(dense_, other.dense_);
+    }
+
+private:
+    int num_vertices_ = 0;
+    std::vector<uint64_t> bits_;
+    std::vector<int> list_;  // the members while the frontier is sparse
+    long long size_ = 0;
+    bool dense_ = false;
+};
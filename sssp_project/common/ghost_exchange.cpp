@@ -0,0 +1,247 @@
+#include "ghost_exchange.h"
+#include <algorithm>
+#include <iostream>
+
+// Point-to-point labels of the asynchronous mode
+const int LABEL_TAG = 1;
+
+GhostExchange::GhostExchange(const CSRGraph& graph, const VertexMap& map, MPI_Comm comm)
+    : map_(map), comm_(comm), subscribers_(map.numOwned()) {
+    MPI_Comm_rank(comm, &rank_);
+    MPI_Comm_size(comm, &nprocs_);
+    slot_.assign(nprocs_, -1);
+
+    for (int l = 0; l < map.numOwned(); ++l) {
+        auto& subs = subscribers_[l];
+        graph.forEachEdge(map.row(l), [&](int n, long long) {
+            int l = map.local(n);
+            if (l >= 0 && !map.owned(l)) subs.push_back(map.owner(l));
+        });
+        std::sort(subs.begin(), subs.end());
+        subs.erase(std::unique(subs.begin(), subs.end()), subs.end());
+        for (int o : subs) {
+            if (slot_[o] < 0) {
+                slot_[o] = 0;
+                neighbors_.push_back(o);
+            }
+        }
+    }
+    link();
+}
+
+GhostExchange::~GhostExchange() {
+    int finalized;
+    MPI_Finalized(&finalized);
+    if (!finalized && neighborhood_ != MPI_COMM_NULL) MPI_Comm_free(&neighborhood_);
+}
+
+// Symmetrizes the neighbor set (a rank must also hear from the ranks that send to it)
+// and rebuilds the neighborhood communicator over it
+void GhostExchange::link() {
+    std::vector<int> mine(nprocs_, 0), theirs(nprocs_);
+    for (int o : neighbors_) mine[o] = 1;
+    MPI_Alltoall(mine.data(), 1, MPI_INT, theirs.data(), 1, MPI_INT, comm_);
+
+    std::vector<std::vector<long long>> pending(nprocs_);
+    for (int o = 0; o < nprocs_; ++o) {
+        if (slot_[o] >= 0 && slot_[o] < (int)out_.size()) pending[o].swap(out_[slot_[o]]);
+    }
+    neighbors_.clear();
+    for (int o = 0; o < nprocs_; ++o) {
+        slot_[o] = -1;
+        if (o != rank_ && (mine[o] || theirs[o])) {
+            slot_[o] = neighbors_.size();
+            neighbors_.push_back(o);
+        }
+    }
+    out_.assign(neighbors_.size(), {});
+    for (int o : neighbors_) out_[slot_[o]].swap(pending[o]);
+
+    if (neighborhood_ != MPI_COMM_NULL) MPI_Comm_free(&neighborhood_);
+    int k = neighbors_.size();
+    MPI_Dist_graph_create_adjacent(comm_, k, neighbors_.data(), MPI_UNWEIGHTED, k, neighbors_.data(), MPI_UNWEIGHTED,
+                                   MPI_INFO_NULL, 0, &neighborhood_);
+    grown_ = false;
+}
+
+int GhostExchange::addEdge(int u, int v) {
+    if (map_.owned(v)) return -1;
+    int o = map_.owner(v);
+    auto& subs = subscribers_[u];
+    if (std::find(subs.begin(), subs.end(), o) != subs.end()) return -1;
+    subs.push_back(o);
+    if (slot_[o] < 0) {
+        neighbors_.push_back(o);
+        grown_ = true;
+    }
+    return o;
+}
+
+void GhostExchange::refresh() {
+    int grown = grown_;
+    MPI_Allreduce(MPI_IN_PLACE, &grown, 1, MPI_INT, MPI_LOR, comm_);
+    if (grown) link();
+}
+
+void GhostExchange::send(int rank, int l, long long dist, int parent) {
+    int s = slot_[rank];
+    if (s < 0) {
+        std::cerr << "Rank " << rank_ << ": no cut edge links rank " << rank << " for vertex " << map_.global(l) << "\n";
+        MPI_Abort(comm_, 1);
+    }
+    out_[s].insert(out_[s].end(), {map_.global(l), parent < 0 ? -1 : map_.global(parent), dist});
+    ++queued_;
+}
+
+void GhostExchange::post(int l, long long dist, int parent) {
+    if (!owns(l)) {
+        send(map_.owner(l), l, dist, parent);
+        return;
+    }
+    for (int o : subscribers_[l]) send(o, l, dist, parent);
+}
+
+void GhostExchange::postTo(int rank, int l, long long dist, int parent) { send(rank, l, dist, parent); }
+
+void GhostExchange::exchange(std::vector<LabelMessage>& received) {
+    start();
+    finish(received);
+}
+
+void GhostExchange::start() {
+    int k = neighbors_.size();
+    scounts_.assign(k, 0);
+    sdispls_.assign(k, 0);
+    rcounts_.assign(k, 0);
+    for (int i = 0; i < k; ++i) scounts_[i] = out_[i].size();
+    for (int i = 1; i < k; ++i) sdispls_[i] = sdispls_[i - 1] + scounts_[i - 1];
+    sendbuf_.clear();
+    sendbuf_.reserve(queued_ * 3);
+    for (auto& o : out_) {
+        sendbuf_.insert(sendbuf_.end(), o.begin(), o.end());
+        o.clear();
+    }
+    messages_ += queued_;
+    queued_ = 0;
+    MPI_Ineighbor_alltoall(scounts_.data(), 1, MPI_INT, rcounts_.data(), 1, MPI_INT, neighborhood_, &counts_req_);
+}
+
+void GhostExchange::startPayload() {
+    int k = neighbors_.size();
+    rdispls_.assign(k, 0);
+    for (int i = 1; i < k; ++i) rdispls_[i] = rdispls_[i - 1] + rcounts_[i - 1];
+    recvbuf_.resize(k ? rdispls_[k - 1] + rcounts_[k - 1] : 0);
+    MPI_Ineighbor_alltoallv(sendbuf_.data(), scounts_.data(), sdispls_.data(), MPI_LONG_LONG, recvbuf_.data(),
+                            rcounts_.data(), rdispls_.data(), MPI_LONG_LONG, neighborhood_, &payload_req_);
+}
+
+bool GhostExchange::progress() {
+    int done;
+    if (counts_req_ != MPI_REQUEST_NULL) {
+        MPI_Test(&counts_req_, &done, MPI_STATUS_IGNORE);
+        if (!done) return false;
+        startPayload();
+    }
+    MPI_Test(&payload_req_, &done, MPI_STATUS_IGNORE);
+    return done;
+}
+
+void GhostExchange::finish(std::vector<LabelMessage>& received) {
+    if (counts_req_ != MPI_REQUEST_NULL) {
+        MPI_Wait(&counts_req_, MPI_STATUS_IGNORE);
+        startPayload();
+    }
+    MPI_Wait(&payload_req_, MPI_STATUS_IGNORE);
+    received.clear();
+    decode(recvbuf_, received);
+}
+
+// Appends the labels of a (v, parent, dist) wire buffer in local ids
+void GhostExchange::decode(const std::vector<long long>& buf, std::vector<LabelMessage>& received) const {
+    for (size_t i = 0; i + 2 < buf.size(); i += 3) {
+        int v = map_.local(buf[i]);
+        if (v < 0) {
+            std::cerr << "Rank " << rank_ << ": received a label for vertex " << buf[i] << " it does not hold\n";
+            MPI_Abort(comm_, 1);
+        }
+        received.push_back({v, buf[i + 1] < 0 ? -1 : map_.local(buf[i + 1]), buf[i + 2]});
+    }
+}
+
+void GhostExchange::flush() {
+    in_flight_.erase(std::remove_if(in_flight_.begin(), in_flight_.end(),
+                                    [](auto& s) {
+                                        int done;
+                                        MPI_Test(&s.first, &done, MPI_STATUS_IGNORE);
+                                        return done != 0;
+                                    }),
+                     in_flight_.end());
+    for (size_t i = 0; i < out_.size(); ++i) {
+        if (out_[i].empty()) continue;
+        in_flight_.emplace_back(MPI_REQUEST_NULL, std::move(out_[i]));
+        out_[i].clear();
+        auto& s = in_flight_.back();
+        MPI_Isend(s.second.data(), s.second.size(), MPI_LONG_LONG, neighbors_[i], LABEL_TAG, neighborhood_, &s.first);
+        ++sent_;
+    }
+    messages_ += queued_;
+    queued_ = 0;
+}
+
+void GhostExchange::poll(std::vector<LabelMessage>& received) {
+    received.clear();
+    for (;;) {
+        int arrived;
+        MPI_Status status;
+        MPI_Iprobe(MPI_ANY_SOURCE, LABEL_TAG, neighborhood_, &arrived, &status);
+        if (!arrived) break;
+        int count;
+        MPI_Get_count(&status, MPI_LONG_LONG, &count);
+        recvbuf_.resize(count);
+        MPI_Recv(recvbuf_.data(), count, MPI_LONG_LONG, status.MPI_SOURCE, LABEL_TAG, neighborhood_, MPI_STATUS_IGNORE);
+        ++received_;
+        decode(recvbuf_, received);
+    }
+}
+
+bool GhostExchange::quiescent(bool idle) {
+    if (wave_req_ != MPI_REQUEST_NULL) {
+        int done;
+        MPI_Test(&wave_req_, &done, MPI_STATUS_IGNORE);
+        if (!done) return false;
+        bool settled = wave_[0] == wave_[1] && wave_[0] == last_wave_[0] && wave_[1] == last_wave_[1];
+        last_wave_[0] = wave_[0];
+        last_wave_[1] = wave_[1];
+        if (settled) {
+            // Every message was received, so the sends are complete as well
+            for (auto& s : in_flight_) MPI_Wait(&s.first, MPI_STATUS_IGNORE);
+            in_flight_.clear();
+            last_wave_[0] = last_wave_[1] = -1;
+            return true;
+        }
+    }
+    if (idle) {
+        wave_in_[0] = sent_;
+        wave_in_[1] = received_;
+        MPI_Iallreduce(wave_in_, wave_, 2, MPI_LONG_LONG, MPI_SUM, comm_, &wave_req_);
+    }
+    return false;
+}
+
+void localize_labels(const VertexMap& map, GhostExchange& ghosts, const std::vector<long long>& full_dist,
+                     const std::vector<int>& full_parent, std::vector<long long>& dist, std::vector<int>& parent) {
+    dist.assign(map.size(), DIST_INF);
+    parent.assign(map.size(), -1);
+    for (int l = 0; l < map.numOwned(); ++l) {
+        int v = map.global(l);
+        dist[l] = full_dist[v];
+        parent[l] = full_parent[v] < 0 ? -1 : map.local(full_parent[v]);
+        ghosts.post(l, dist[l], parent[l]);
+    }
+    std::vector<LabelMessage> received;
+    ghosts.exchange(received);
+    for (const LabelMessage& m : received) {
+        dist[m.v] = m.dist;
+        parent[m.v] = m.parent;
+    }
+}
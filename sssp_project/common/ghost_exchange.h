@@ -0,0 +1,111 @@
+#pragma once
+#include <vector>
+#include <mpi.h>
+#include "csr_graph.h"
+#include "vertex_map.h"
+
+// One vertex label as the drivers see it, in local ids of the VertexMap (parent -1 for
+// none or one this rank does not hold). Sent by the owner it is the label to take over;
+// sent to the owner it is a proposal (the smaller distance wins) or, with
+// dist == DIST_INF, an invalidation of a vertex whose tree parent lost its distance.
+struct LabelMessage {
+    int v;
+    int parent;
+    long long dist;
+};
+
+// Label exchange of the dynamic-update loops. A vertex is a ghost on every rank that owns
+// one of its neighbors; those ranks are its subscribers, found from the cut edges. A
+// changed owned vertex goes to its subscribers only, a changed ghost to its owner only,
+// over a neighborhood communicator that links just the ranks sharing a cut edge, so one
+// round costs the labels that changed on the boundary instead of a |V| reduction. Labels
+// travel with global ids and are translated through the map on both ends.
+//
+// Subscriber sets only grow: a deleted edge keeps its endpoints subscribed, which keeps
+// a former tree neighbor informed of the label that replaced it.
+class GhostExchange {
+public:
+    // Collective
+    GhostExchange(const CSRGraph& graph, const VertexMap& map, MPI_Comm comm);
+    ~GhostExchange();
+    GhostExchange(const GhostExchange&) = delete;
+    GhostExchange& operator=(const GhostExchange&) = delete;
+
+    bool owns(int l) const { return map_.owned(l); }
+    // A ghost, or an owned vertex some other rank holds as a ghost. Relaxing only
+    // non-boundary vertices never changes a label another rank holds.
+    bool isBoundary(int l) const { return !owns(l) || !subscribers_[l].empty(); }
+    int neighborRanks() const { return neighbors_.size(); }
+
+    // Edge (u, v) was inserted into the row of owned u; v must be in the map. Returns the
+    // rank that just subscribed to u, which has yet to learn u's label, or -1.
+    int addEdge(int u, int v);
+    // Collective. Relinks the neighborhood once an inserted edge joined two ranks that
+    // shared no edge before; a no-op (one scalar reduction) otherwise.
+    void refresh();
+
+    // Queues l's label: to its subscribers when l is owned here, else to its owner
+    void post(int l, long long dist, int parent);
+    // Queues the label of owned l for one subscriber
+    void postTo(int rank, int l, long long dist, int parent);
+    long long queued() const { return queued_; }
+
+    // Collective. Delivers the queued labels and replaces received with what arrived.
+    void exchange(std::vector<LabelMessage>& received);
+
+    // The same exchange split up so local work can run while it is in flight. start()
+    // sends what is queued; labels posted afterwards wait for the next exchange. The
+    // neighborhood must not be refreshed before finish().
+    void start();
+    // Advances the exchange; true once every label has arrived
+    bool progress();
+    void finish(std::vector<LabelMessage>& received);
+
+    // Asynchronous use, with no rounds at all: flush() sends what is queued right away,
+    // one point-to-point message per neighbor, and poll() replaces received with the
+    // messages that have arrived so far.
+    void flush();
+    void poll(std::vector<LabelMessage>& received);
+    // Collective over repeated calls. Termination by message counting: idle (no local
+    // work, nothing queued) ranks start non-blocking sums of the messages sent and
+    // received so far. Two consecutive sums that agree, with every message received,
+    // mean no rank became active in between; true then, on every rank in the same call.
+    bool quiescent(bool idle);
+
+    long long messages() const { return messages_; }  // labels sent to other ranks
+
+private:
+    void link();
+    void send(int rank, int l, long long dist, int parent);
+    void startPayload();
+    void decode(const std::vector<long long>& buf, std::vector<LabelMessage>& received) const;
+
+    const VertexMap& map_;
+    MPI_Comm comm_;
+    MPI_Comm neighborhood_ = MPI_COMM_NULL;
+    int rank_, nprocs_;
+    std::vector<std::vector<int>> subscribers_;  // by owned local id
+    std::vector<int> neighbors_;
+    std::vector<int> slot_;                      // rank -> index in neighbors_, -1 if none
+    bool grown_ = false;
+    std::vector<std::vector<long long>> out_;    // by neighbor index: v, parent, dist (global ids)
+    long long queued_ = 0;
+    long long messages_ = 0;
+
+    // The exchange in flight: per-neighbor counts first, then the labels
+    MPI_Request counts_req_ = MPI_REQUEST_NULL, payload_req_ = MPI_REQUEST_NULL;
+    std::vector<int> scounts_, rcounts_, sdispls_, rdispls_;
+    std::vector<long long> sendbuf_, recvbuf_;
+
+    // Asynchronous mode: sends not yet completed, message counts, termination waves
+    std::vector<std::pair<MPI_Request, std::vector<long long>>> in_flight_;
+    long long sent_ = 0, received_ = 0;
+    MPI_Request wave_req_ = MPI_REQUEST_NULL;
+    long long wave_in_[2], wave_[2], last_wave_[2] = {-1, -1};
+};
+
+// Collective. Local arrays (by local id) from an SSSP result on full-length arrays that
+// only has to be valid for the owned vertices: owned labels are copied, and every ghost
+// gets its label from its owner.
+void localize_labels(const VertexMap& map, GhostExchange& ghosts, const std::vector<long long>& full_dist,
+                     const std::vector<int>& full_parent, std::vector<long long>& dist, std::vector<int>& parent);
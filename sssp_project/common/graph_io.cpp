@@ -0,0 +1,211 @@
+#include "graph_io.h"
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <limits>
+#include "mapped_file.h"
+#include "text_parser.h"
+
+namespace {
+
+uint64_t align8(uint64_t pos) { return (pos + 7) & ~uint64_t(7); }
+
+// True if count elements of elem bytes at pos lie within size bytes, without overflowing
+bool section_fits(uint64_t pos, uint64_t count, uint64_t elem, uint64_t size) {
+    return pos <= size && count <= (size - pos) / elem;
+}
+
+} // namespace
+
+bool parse_text_format(const std::string& name, TextFormat& format) {
+    if (name == "metis") format = TextFormat::Metis;
+    else if (name == "edges") format = TextFormat::Edges;
+    else if (name == "snap") format = TextFormat::Snap;
+    else return false;
+    return true;
+}
+
+bool is_binary_graph(const std::string& path) {
+    std::ifstream in(path, std::ios::binary);
+    char magic[sizeof(GRAPH_MAGIC)] = {};
+    in.read(magic, sizeof(magic));
+    return in && std::memcmp(magic, GRAPH_MAGIC, sizeof(GRAPH_MAGIC)) == 0;
+}
+
+bool load_text_graph(const std::string& path, TextFormat format, CSRGraph& graph) {
+    ParsedEdges parsed;
+    if (!parse_text_edges(path, format, parsed)) return false;
+    graph = build_undirected_csr(parsed);
+    return true;
+}
+
+bool map_binary_graph(const std::string& path, LoadedGraph& out) {
+    auto mapping = MappedFile::open(path);
+    if (!mapping) return false;
+    if (mapping->size() < sizeof(BinaryGraphHeader)) {
+        std::cerr << "Graph file " << path << " is too small\n";
+        return false;
+    }
+
+    const char* base = mapping->data();
+    BinaryGraphHeader h;
+    std::memcpy(&h, base, sizeof(h));
+    if (std::memcmp(h.magic, GRAPH_MAGIC, sizeof(GRAPH_MAGIC)) != 0 || h.version != GRAPH_VERSION) {
+        std::cerr << "Graph file " << path << " has an unknown format or version\n";
+        return false;
+    }
+
+    if (h.num_vertices > (uint64_t)std::numeric_limits<int>::max()) {
+        std::cerr << "Graph file " << path << " has more vertices than an int holds\n";
+        return false;
+    }
+    uint64_t size = mapping->size();
+    bool fits = section_fits(h.offsets_pos, h.num_vertices + 1, sizeof(int64_t), size) &&
+                section_fits(h.neighbors_pos, h.num_entries, sizeof(int32_t), size);
+    if (h.flags & GRAPH_HAS_WEIGHTS) fits = fits && section_fits(h.weights_pos, h.num_entries, sizeof(int32_t), size);
+    if (h.flags & GRAPH_HAS_PARTITION) {
+        fits = fits && section_fits(h.partition_pos, h.num_vertices, sizeof(int32_t), size);
+    }
+    if (!fits) {
+        std::cerr << "Graph file " << path << " is truncated\n";
+        return false;
+    }
+
+    const long long* offsets = reinterpret_cast<const long long*>(base + h.offsets_pos);
+    bool valid = h.offsets_pos % sizeof(int64_t) == 0 && offsets[0] == 0 &&
+                 offsets[h.num_vertices] == (long long)h.num_entries;
+    for (uint64_t v = 0; valid && v < h.num_vertices; ++v) valid = offsets[v] <= offsets[v + 1];
+    if (!valid) {
+        std::cerr << "Graph file " << path << " has an invalid offset table\n";
+        return false;
+    }
+    const int* adj = reinterpret_cast<const int*>(base + h.neighbors_pos);
+    const int* wts = (h.flags & GRAPH_HAS_WEIGHTS) ? reinterpret_cast<const int*>(base + h.weights_pos) : nullptr;
+
+    out.graph = CSRGraph::fromArrays(h.num_vertices, offsets, adj, wts, mapping);
+    out.partition.clear();
+    out.num_parts = 0;
+    if (h.flags & GRAPH_HAS_PARTITION) {
+        const int* part = reinterpret_cast<const int*>(base + h.partition_pos);
+        out.partition.assign(part, part + h.num_vertices);
+        out.num_parts = h.num_parts;
+    }
+    return true;
+}
+
+bool map_partitioned_graph(const std::string& path, const PartitionSpec& spec, int rank, int nprocs,
+                           CSRGraph& graph) {
+    LoadedGraph loaded;
+    if (!map_binary_graph(path, loaded)) return false;
+    int n = loaded.graph.numVertices();
+    if (!spec.file.empty()) {
+        if (!read_partition_file(spec.file, n, loaded.partition)) return false;
+    } else if (loaded.partition.empty() || loaded.num_parts != nprocs) {
+        PartitionStats stats;
+        loaded.partition = stream_partition(loaded.graph, nprocs, spec.method, spec.slack, &stats);
+        if (rank == 0) print_partition_stats(stats);
+    }
+
+    graph = std::move(loaded.graph);
+    graph.localVertices.clear();
+    for (int v = 0; v < n; ++v) {
+        if (loaded.partition[v] == rank) graph.localVertices.push_back(v);
+    }
+    return true;
+}
+
+bool load_graph(const std::string& path, TextFormat format, LoadedGraph& out) {
+    if (is_binary_graph(path)) return map_binary_graph(path, out);
+    out.partition.clear();
+    out.num_parts = 0;
+    return load_text_graph(path, format, out.graph);
+}
+
+bool write_binary_graph(const std::string& path, const CSRGraph& graph, const std::vector<int>& partition,
+                        int num_parts) {
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    if (!out) {
+        std::cerr << "Error creating " << path << "\n";
+        return false;
+    }
+
+    int n = graph.numVertices();
+    std::vector<long long> offsets(n + 1, 0);
+    std::vector<int32_t> adj, wts;
+    adj.reserve(graph.numEntries());
+    for (int u = 0; u < n; ++u) {
+        graph.forEachEdge(graph.row(u), [&](int v, int w) {
+            adj.push_back(v);
+            wts.push_back(w);
+        });
+        offsets[u + 1] = adj.size();
+    }
+    bool weighted = !graph.unitWeights();
+
+    BinaryGraphHeader h = {};
+    std::memcpy(h.magic, GRAPH_MAGIC, sizeof(GRAPH_MAGIC));
+    h.version = GRAPH_VERSION;
+    h.flags = (weighted ? GRAPH_HAS_WEIGHTS : 0) | (!partition.empty() ? GRAPH_HAS_PARTITION : 0);
+    h.num_vertices = n;
+    h.num_entries = adj.size();
+    h.num_parts = num_parts;
+    h.offsets_pos = align8(sizeof(h));
+    h.neighbors_pos = align8(h.offsets_pos + offsets.size() * sizeof(int64_t));
+    uint64_t pos = align8(h.neighbors_pos + adj.size() * sizeof(int32_t));
+    if (weighted) {
+        h.weights_pos = pos;
+        pos = align8(pos + wts.size() * sizeof(int32_t));
+    }
+    if (!partition.empty()) h.partition_pos = pos;
+
+    auto write_at = [&](uint64_t at, const void* data, size_t bytes) {
+        out.seekp(at);
+        out.write(static_cast<const char*>(data), bytes);
+    };
+    write_at(0, &h, sizeof(h));
+    write_at(h.offsets_pos, offsets.data(), offsets.size() * sizeof(int64_t));
+    write_at(h.neighbors_pos, adj.data(), adj.size() * sizeof(int32_t));
+    if (weighted) write_at(h.weights_pos, wts.data(), wts.size() * sizeof(int32_t));
+    if (!partition.empty()) write_at(h.partition_pos, partition.data(), partition.size() * sizeof(int32_t));
+    if (!out) {
+        std::cerr << "Error writing " << path << "\n";
+        return false;
+    }
+    return true;
+}
+
+bool write_metis_graph(const std::string& path, const CSRGraph& graph) {
+    std::ofstream out(path);
+    if (!out) {
+        std::cerr << "Error creating " << path << "\n";
+        return false;
+    }
+    out << graph.numVertices() << " " << graph.numEntries() / 2 << "\n";
+    for (int u = 0; u < graph.numVertices(); ++u) {
+        bool first = true;
+        graph.forEachEdge(graph.row(u), [&](int v, int) {
+            out << (first ? "" : " ") << v + 1;
+            first = false;
+        });
+        out << "\n";
+    }
+    return bool(out);
+}
+
+bool read_partition_file(const std::string& path, int num_vertices, std::vector<int>& partition) {
+    std::ifstream pfile(path);
+    if (!pfile) {
+        std::cerr << "Error opening partition file " << path << "\n";
+        return false;
+    }
+    partition.clear();
+    partition.reserve(num_vertices);
+    int p;
+    while ((int)partition.size() < num_vertices && pfile >> p) partition.push_back(p);
+    if ((int)partition.size() != num_vertices) {
+        std::cerr << "Partition file has " << partition.size() << " entries, expected " << num_vertices << "\n";
+        return false;
+    }
+    return true;
+}
@@ -0,0 +1,67 @@
+#pragma once
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "csr_graph.h"
+#include "partitioner.h"
+
+// Binary CSR file written by sssp_convert. Sections follow the header in this
+// order, each starting at the byte offset recorded in the header (8-byte aligned):
+//   offsets   int64[num_vertices + 1]
+//   neighbors int32[num_entries]
+//   weights   int32[num_entries]     only if GRAPH_HAS_WEIGHTS
+//   partition int32[num_vertices]    only if GRAPH_HAS_PARTITION
+const char GRAPH_MAGIC[8] = {'S', 'S', 'S', 'P', 'C', 'S', 'R', '\0'};
+const uint32_t GRAPH_VERSION = 1;
+const uint32_t GRAPH_HAS_WEIGHTS = 1u << 0;
+const uint32_t GRAPH_HAS_PARTITION = 1u << 1;
+
+struct BinaryGraphHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t flags;
+    uint64_t num_vertices;
+    uint64_t num_entries;   // directed adjacency entries (2x undirected edges)
+    uint32_t num_parts;     // partition count when GRAPH_HAS_PARTITION
+    uint32_t reserved;
+    uint64_t offsets_pos;
+    uint64_t neighbors_pos;
+    uint64_t weights_pos;
+    uint64_t partition_pos;
+};
+
+enum class TextFormat {
+    Metis,  // "n m" header, line i lists the 1-based neighbors of vertex i
+    Edges,  // "n m" header, then one 0-based "u v [w]" pair per line
+    Snap    // '#' comments, "u v [w]" pairs with arbitrary ids, relabeled to 0..n-1
+};
+
+struct LoadedGraph {
+    CSRGraph graph;
+    std::vector<int> partition; // empty unless the file carries one
+    int num_parts = 0;
+};
+
+bool parse_text_format(const std::string& name, TextFormat& format);
+bool is_binary_graph(const std::string& path);
+
+// Parses a text graph into an undirected CSR without self-loops or duplicate edges.
+bool load_text_graph(const std::string& path, TextFormat format, CSRGraph& graph);
+
+// Maps a binary graph read-only. The CSR arrays point straight into the mapping, so
+// every process on a node shares the same page cache.
+bool map_binary_graph(const std::string& path, LoadedGraph& out);
+
+// Maps a binary graph and marks the vertices assigned to `rank` of `nprocs` as local. The
+// partition comes from spec.file if set, else from the file itself when it was written
+// for nprocs parts, else every rank runs the same deterministic streaming pass.
+bool map_partitioned_graph(const std::string& path, const PartitionSpec& spec, int rank, int nprocs,
+                           CSRGraph& graph);
+
+// Binary files are mapped, anything else is parsed as `format`.
+bool load_graph(const std::string& path, TextFormat format, LoadedGraph& out);
+
+bool write_binary_graph(const std::string& path, const CSRGraph& graph, const std::vector<int>& partition = {},
+                        int num_parts = 0);
+bool write_metis_graph(const std::string& path, const CSRGraph& graph);
+bool read_partition_file(const std::string& path, int num_vertices, std::vector<int>& partition);
@@ -0,0 +1,198 @@
+#include "landmarks.h"
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include "bfs.h"
+#include "dijkstra.h"
+
+bool parse_landmark_selection(const std::string& name, LandmarkSelection& selection) {
+    if (name == "degree") selection = LandmarkSelection::Degree;
+    else if (name == "farthest") selection = LandmarkSelection::Farthest;
+    else return false;
+    return true;
+}
+
+void LandmarkIndex::build(const CSRGraph& graph, int k, LandmarkSelection selection) {
+    int n = graph.numVertices();
+    k = std::max(0, std::min(k, n));
+    num_vertices_ = n;
+    landmarks_.clear();
+    dist_.assign((size_t)n * k, -1);
+    if (k == 0) return;
+
+    std::vector<int> order(n);
+    std::vector<int> degree(n);
+    for (int v = 0; v < n; ++v) {
+        order[v] = v;
+        degree[v] = graph.row(v) < 0 ? 0 : graph.degree(graph.row(v));
+    }
+    int picks = selection == LandmarkSelection::Degree ? k : 1;
+    std::partial_sort(order.begin(), order.begin() + picks, order.end(),
+                      [&](int a, int b) { return degree[a] != degree[b] ? degree[a] > degree[b] : a < b; });
+
+    // Farthest-point selection: each pick maximizes the distance to the closest landmark
+    // so far; vertices no landmark reaches count as infinitely far
+    std::vector<long long> closest(n, DIST_INF);
+    std::vector<long long> d;
+    std::vector<int> parent;
+    DirectionOptimizingBFS bfs(graph);
+    int next = order[0];
+    for (int i = 0; i < k; ++i) {
+        int l = selection == LandmarkSelection::Degree ? order[i] : next;
+        landmarks_.push_back(l);
+        if (graph.unitWeights()) bfs.run(l, d, parent);
+        else dijkstra(graph, l, QueueKind::Radix, d, parent);
+        for (int v = 0; v < n; ++v) {
+            if (d[v] != DIST_INF) dist_[(size_t)v * k + i] = (int32_t)d[v];
+            closest[v] = std::min(closest[v], d[v]);
+        }
+        next = std::max_element(closest.begin(), closest.end()) - closest.begin();
+        if (selection == LandmarkSelection::Farthest && closest[next] == 0) break;
+    }
+
+    // Farthest-point selection stopped early because every vertex already is a landmark
+    if ((int)landmarks_.size() < k) {
+        size_t m = landmarks_.size();
+        std::vector<int32_t> packed((size_t)n * m);
+        for (int v = 0; v < n; ++v) {
+            auto first = dist_.begin() + (size_t)v * k;
+            std::copy(first, first + m, packed.begin() + v * m);
+        }
+        dist_.swap(packed);
+    }
+}
+
+bool LandmarkIndex::save(const std::string& path) const {
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    if (!out) {
+        std::cerr << "Error creating " << path << "\n";
+        return false;
+    }
+    uint32_t version = LANDMARK_VERSION;
+    uint32_t k = landmarks_.size();
+    uint64_t n = num_vertices_;
+    out.write(LANDMARK_MAGIC, sizeof(LANDMARK_MAGIC));
+    out.write(reinterpret_cast<const char*>(&version), sizeof(version));
+    out.write(reinterpret_cast<const char*>(&k), sizeof(k));
+    out.write(reinterpret_cast<const char*>(&n), sizeof(n));
+    std::vector<int32_t> ids(landmarks_.begin(), landmarks_.end());
+    out.write(reinterpret_cast<const char*>(ids.data()), ids.size() * sizeof(int32_t));
+    out.write(reinterpret_cast<const char*>(dist_.data()), dist_.size() * sizeof(int32_t));
+    if (!out) {
+        std::cerr << "Error writing " << path << "\n";
+        return false;
+    }
+    return true;
+}
+
+bool LandmarkIndex::load(const std::string& path) {
+    std::ifstream in(path, std::ios::binary);
+    if (!in) {
+        std::cerr << "Error opening landmark index " << path << "\n";
+        return false;
+    }
+    char magic[8];
+    uint32_t version, k;
+    uint64_t n;
+    in.read(magic, sizeof(magic));
+    in.read(reinterpret_cast<char*>(&version), sizeof(version));
+    in.read(reinterpret_cast<char*>(&k), sizeof(k));
+    in.read(reinterpret_cast<char*>(&n), sizeof(n));
+    if (!in || std::memcmp(magic, LANDMARK_MAGIC, sizeof(magic)) != 0 || version != LANDMARK_VERSION) {
+        std::cerr << "Landmark index " << path << " has an unknown format or version\n";
+        return false;
+    }
+    std::vector<int32_t> ids(k);
+    dist_.resize((size_t)n * k);
+    in.read(reinterpret_cast<char*>(ids.data()), ids.size() * sizeof(int32_t));
+    in.read(reinterpret_cast<char*>(dist_.data()), dist_.size() * sizeof(int32_t));
+    if (!in) {
+        std::cerr << "Landmark index " << path << " is truncated\n";
+        return false;
+    }
+    landmarks_.assign(ids.begin(), ids.end());
+    num_vertices_ = n;
+    return true;
+}
+
+std::pair<long long, long long> LandmarkIndex::bounds(int s, int t) const {
+    long long lower = 0, upper = DIST_INF;
+    const int32_t* a = row(s);
+    const int32_t* b = row(t);
+    for (size_t i = 0; i < landmarks_.size(); ++i) {
+        if (a[i] < 0 && b[i] < 0) continue;
+        // A landmark reaching only one of them separates two components
+        if (a[i] < 0 || b[i] < 0) return {DIST_INF, DIST_INF};
+        lower = std::max<long long>(lower, std::abs(a[i] - b[i]));
+        upper = std::min<long long>(upper, (long long)a[i] + b[i]);
+    }
+    return {lower, upper};
+}
+
+long long LandmarkIndex::lowerBound(int v, int t) const {
+    return bounds(v, t).first;
+}
+
+long long LandmarkIndex::exact(const CSRGraph& graph, int s, int t, std::vector<int>* path) {
+    int n = graph.numVertices();
+    if (path) path->clear();
+    settled_ = 0;
+    if (s < 0 || s >= n || t < 0 || t >= n || n != num_vertices_) return DIST_INF;
+    auto [lower, upper] = bounds(s, t);
+    if (lower == DIST_INF) return DIST_INF;
+    // Matching bounds already are the answer
+    if (!path && lower == upper) return lower;
+    if ((int)g_.size() != n) {
+        g_.assign(n, DIST_INF);
+        h_.assign(n, -1);
+        parent_.assign(n, -1);
+    }
+    // The heuristic is computed once per vertex a query reaches
+    auto touch = [&](int v) {
+        touched_.push_back(v);
+        h_[v] = lowerBound(v, t);
+    };
+    auto pop = [&]() {
+        std::pop_heap(heap_.begin(), heap_.end(), std::greater<>());
+        heap_.pop_back();
+    };
+
+    touch(s);
+    g_[s] = 0;
+    heap_.push_back({h_[s], h_[s], s});
+    while (!heap_.empty()) {
+        auto [f, h, u] = heap_.front();
+        pop();
+        if (f != g_[u] + h_[u]) continue;
+        if (u == t) break;
+        ++settled_;
+        int r = graph.row(u);
+        if (r < 0) continue;
+        graph.forEachEdge(r, [&](int v, int w) {
+            long long nd = g_[u] + w;
+            if (h_[v] < 0) touch(v);
+            if (nd >= g_[v] || h_[v] == DIST_INF) return;
+            g_[v] = nd;
+            parent_[v] = u;
+            heap_.push_back({nd + h_[v], h_[v], v});
+            std::push_heap(heap_.begin(), heap_.end(), std::greater<>());
+        });
+    }
+
+    long long result = g_[t];
+    if (path && result != DIST_INF) {
+        for (int v = t; v != -1; v = parent_[v]) path->push_back(v);
+        std::reverse(path->begin(), path->end());
+    }
+    for (int v : touched_) {
+        g_[v] = DIST_INF;
+        h_[v] = -1;
+        parent_[v] = -1;
+    }
+    touched_.clear();
+    heap_.clear();
+    return result;
+}
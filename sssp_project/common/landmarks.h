@@ -0,0 +1,61 @@
+#pragma once
+#include <cstdint>
+#include <string>
+#include <tuple>
+#include <utility>
+#include <vector>
+#include "csr_graph.h"
+
+enum class LandmarkSelection {
+    Degree,   // the k highest-degree vertices
+    Farthest  // highest degree first, then repeatedly the vertex farthest from those chosen
+};
+
+// "degree" or "farthest"; false if the name is unknown
+bool parse_landmark_selection(const std::string& name, LandmarkSelection& selection);
+
+// ALT index (Goldberg & Harrelson): exact distances from k landmarks to every vertex.
+// For an undirected graph the triangle inequality bounds any d(s, t) by
+//   max_i |d(L_i, s) - d(L_i, t)|  <=  d(s, t)  <=  min_i d(L_i, s) + d(L_i, t)
+// which answers approximate queries in O(k), and the lower bound is a consistent A*
+// heuristic for exact queries. The index describes the graph it was built on, so it
+// has to be rebuilt after edge updates.
+//
+// Index file: 8-byte magic "SSSPLMRK", uint32 version, uint32 k, uint64 vertex count,
+// int32 landmarks[k], then int32 distances[vertex count][k] (-1 = unreachable).
+const char LANDMARK_MAGIC[8] = {'S', 'S', 'S', 'P', 'L', 'M', 'R', 'K'};
+const uint32_t LANDMARK_VERSION = 1;
+
+class LandmarkIndex {
+public:
+    // Distances come from the repo's Dijkstra (BFS for unit weights)
+    void build(const CSRGraph& graph, int k, LandmarkSelection selection);
+    bool save(const std::string& path) const;
+    bool load(const std::string& path);
+
+    int numVertices() const { return num_vertices_; }
+    const std::vector<int>& landmarks() const { return landmarks_; }
+
+    // O(k) bounds on d(s, t); both DIST_INF if a landmark proves t unreachable from s.
+    // Without a landmark reaching s and t the upper bound stays DIST_INF.
+    std::pair<long long, long long> bounds(int s, int t) const;
+    long long lowerBound(int v, int t) const;
+
+    // Exact distance by A* with the landmark lower bound; path gets s..t if non-null.
+    // The graph must be the one the index was built on.
+    long long exact(const CSRGraph& graph, int s, int t, std::vector<int>* path = nullptr);
+    long long lastSettled() const { return settled_; }
+
+private:
+    const int32_t* row(int v) const { return dist_.data() + (size_t)v * landmarks_.size(); }
+
+    int num_vertices_ = 0;
+    std::vector<int> landmarks_;
+    std::vector<int32_t> dist_;  // vertex-major, so a query reads two contiguous rows
+
+    // A* workspace, reset through touched_ after each query
+    std::vector<long long> g_, h_;  // h_ is -1 until a query reaches the vertex
+    std::vector<int> parent_, touched_;
+    std::vector<std::tuple<long long, long long, int>> heap_;  // (g + h, h, v): ties go deeper
+    long long settled_ = 0;
+};
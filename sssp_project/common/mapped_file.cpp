@@ -0,0 +1,38 @@
+#include "mapped_file.h"
+#include <iostream>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+std::shared_ptr<MappedFile> MappedFile::open(const std::string& path) {
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        std::cerr << "Error opening " << path << "\n";
+        return nullptr;
+    }
+    struct stat st;
+    if (fstat(fd, &st) != 0) {
+        std::cerr << "Error reading size of " << path << "\n";
+        close(fd);
+        return nullptr;
+    }
+
+    std::shared_ptr<MappedFile> file(new MappedFile());
+    file->length_ = st.st_size;
+    if (file->length_ > 0) {
+        void* addr = mmap(nullptr, file->length_, PROT_READ, MAP_SHARED, fd, 0);
+        if (addr == MAP_FAILED) {
+            std::cerr << "Error mapping " << path << "\n";
+            close(fd);
+            return nullptr;
+        }
+        file->addr_ = addr;
+    }
+    close(fd);
+    return file;
+}
+
+MappedFile::~MappedFile() {
+    if (addr_) munmap(addr_, length_);
+}
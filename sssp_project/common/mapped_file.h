@@ -0,0 +1,19 @@
+#pragma once
+#include <cstddef>
+#include <memory>
+#include <string>
+
+// Read-only mmap of a whole file; the mapping lives as long as the last shared_ptr
+class MappedFile {
+public:
+    static std::shared_ptr<MappedFile> open(const std::string& path);
+    ~MappedFile();
+
+    const char* data() const { return static_cast<const char*>(addr_); }
+    size_t size() const { return length_; }
+
+private:
+    MappedFile() = default;
+    void* addr_ = nullptr;
+    size_t length_ = 0;
+};
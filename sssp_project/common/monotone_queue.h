@@ -0,0 +1,140 @@
+#pragma once
+#include <algorithm>
+#include <cstdint>
+#include <functional>
+#include <queue>
+#include <utility>
+#include <vector>
+#include "csr_graph.h"
+
+// Monotone vertex priority queues for Dijkstra. All three share one interface:
+//   push(v, key)  inserts v, or lowers its key if it is already queued
+//   pop()         removes and returns a vertex with the smallest key
+//   empty()
+// Keys never go below the last popped key, and a popped vertex is not pushed again
+// with a smaller key than it was popped with.
+
+// std::priority_queue with lazy deletion: a decrease pushes a second entry and stale
+// entries are skipped on pop. The reference the other two are measured against.
+class BinaryHeapQueue {
+public:
+    explicit BinaryHeapQueue(int num_vertices) : key_(num_vertices, DIST_INF) {}
+
+    bool empty() const { return size_ == 0; }
+    void push(int v, long long key) {
+        if (key_[v] == DIST_INF) ++size_;
+        key_[v] = key;
+        heap_.push({key, v});
+    }
+    int pop() {
+        while (true) {
+            auto [key, v] = heap_.top();
+            heap_.pop();
+            if (key != key_[v]) continue;
+            key_[v] = DIST_INF;
+            --size_;
+            return v;
+        }
+    }
+
+private:
+    std::priority_queue<std::pair<long long, int>, std::vector<std::pair<long long, int>>, std::greater<>> heap_;
+    std::vector<long long> key_;  // DIST_INF when not queued
+    long long size_ = 0;
+};
+
+// Radix heap (Ahuja, Mehlhorn, Orlin & Tarjan). Bucket i holds keys whose highest bit
+// differing from the last popped key is bit i-1, so each entry moves down at most 64
+// times. Entries made stale by a decrease are dropped when their bucket is
+// redistributed instead of surviving until pop.
+class RadixHeap {
+public:
+    explicit RadixHeap(int num_vertices) : key_(num_vertices, DIST_INF) {}
+
+    bool empty() const { return size_ == 0; }
+    void push(int v, long long key) {
+        if (key_[v] == DIST_INF) ++size_;
+        key_[v] = key;
+        buckets_[bucket(key)].push_back({key, v});
+    }
+    int pop() {
+        while (true) {
+            if (buckets_[0].empty()) refill();
+            auto [key, v] = buckets_[0].back();
+            buckets_[0].pop_back();
+            if (key != key_[v]) continue;
+            key_[v] = DIST_INF;
+            --size_;
+            return v;
+        }
+    }
+
+private:
+    int bucket(long long key) const {
+        return key == last_ ? 0 : 64 - __builtin_clzll((uint64_t)(key ^ last_));
+    }
+    // Moves the live entries of the first non-empty bucket down, around their minimum
+    void refill() {
+        int i = 1;
+        while (true) {
+            auto& b = buckets_[i];
+            b.erase(std::remove_if(b.begin(), b.end(), [&](const auto& e) { return e.first != key_[e.second]; }),
+                    b.end());
+            if (!b.empty()) break;
+            ++i;
+        }
+        std::vector<std::pair<long long, int>> moving;
+        moving.swap(buckets_[i]);
+        last_ = DIST_INF;
+        for (const auto& e : moving) last_ = std::min(last_, e.first);
+        for (const auto& e : moving) buckets_[bucket(e.first)].push_back(e);
+    }
+
+    std::vector<std::pair<long long, int>> buckets_[65];
+    std::vector<long long> key_;
+    long long last_ = 0;
+    long long size_ = 0;
+};
+
+// Dial's bucket queue for integer weights in [0, C]: C + 1 buckets used as a circular
+// array, since queued keys always lie within C of the smallest. Buckets are intrusive
+// doubly linked lists over vertex ids, so a decrease moves the vertex instead of
+// leaving a duplicate behind.
+class BucketQueue {
+public:
+    BucketQueue(int num_vertices, int max_weight)
+        : head_((size_t)max_weight + 1, -1), next_(num_vertices, -1), prev_(num_vertices, -1),
+          key_(num_vertices, DIST_INF) {}
+
+    bool empty() const { return size_ == 0; }
+    void push(int v, long long key) {
+        if (key_[v] == DIST_INF) ++size_;
+        else unlink(v);
+        key_[v] = key;
+        int& h = head_[key % head_.size()];
+        prev_[v] = -1;
+        next_[v] = h;
+        if (h >= 0) prev_[h] = v;
+        h = v;
+    }
+    int pop() {
+        while (head_[cursor_ % head_.size()] < 0) ++cursor_;
+        int v = head_[cursor_ % head_.size()];
+        unlink(v);
+        key_[v] = DIST_INF;
+        --size_;
+        return v;
+    }
+
+private:
+    void unlink(int v) {
+        if (prev_[v] >= 0) next_[prev_[v]] = next_[v];
+        else head_[key_[v] % head_.size()] = next_[v];
+        if (next_[v] >= 0) prev_[next_[v]] = prev_[v];
+    }
+
+    std::vector<int> head_, next_, prev_;
+    std::vector<long long> key_;
+    long long cursor_ = 0;
+    long long size_ = 0;
+};
@@ -0,0 +1,167 @@
+#include "multi_source.h"
+#include <algorithm>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <queue>
+
+void multi_source_bfs(const CSRGraph& graph, const int* sources, int count, int32_t* out) {
+    int n = graph.numVertices();
+    uint64_t all = count >= 64 ? ~0ULL : (1ULL << count) - 1;
+    std::fill(out, out + (size_t)count * n, -1);
+    std::vector<uint64_t> seen(n, 0), visit(n, 0), next(n, 0);
+    for (int i = 0; i < count; ++i) {
+        seen[sources[i]] |= 1ULL << i;
+        visit[sources[i]] |= 1ULL << i;
+        out[(size_t)i * n + sources[i]] = 0;
+    }
+
+    // Pull form: each vertex only writes its own words, so no atomics are needed
+    for (int32_t level = 1;; ++level) {
+        int found = 0;
+        #pragma omp parallel for schedule(dynamic, 256) reduction(| : found)
+        for (int v = 0; v < n; ++v) {
+            uint64_t missing = all & ~seen[v];
+            int r = graph.row(v);
+            next[v] = 0;
+            if (!missing || r < 0) continue;
+            uint64_t reached = 0;
+            graph.anyEdge(r, [&](int u, int) {
+                reached |= visit[u];
+                return (reached & missing) == missing;
+            });
+            reached &= missing;
+            if (!reached) continue;
+            next[v] = reached;
+            found = 1;
+            for (uint64_t bits = reached; bits; bits &= bits - 1) {
+                out[(size_t)__builtin_ctzll(bits) * n + v] = level;
+            }
+        }
+        if (!found) break;
+        #pragma omp parallel for schedule(static)
+        for (int v = 0; v < n; ++v) seen[v] |= next[v];
+        visit.swap(next);
+    }
+}
+
+void batched_dijkstra(const CSRGraph& graph, const int* sources, int count, int32_t* out) {
+    int n = graph.numVertices();
+    // Vertex-major, so the labels a row scan reads and writes sit together
+    std::vector<long long> dist((size_t)n * count, DIST_INF);
+    std::vector<uint64_t> pending(n, 0);
+    std::vector<long long> key(n, DIST_INF);  // smallest pending label, DIST_INF when not queued
+    std::priority_queue<std::pair<long long, int>, std::vector<std::pair<long long, int>>, std::greater<>> pq;
+    for (int i = 0; i < count; ++i) {
+        int s = sources[i];
+        dist[(size_t)s * count + i] = 0;
+        pending[s] |= 1ULL << i;
+        if (key[s] != 0) {
+            key[s] = 0;
+            pq.push({0, s});
+        }
+    }
+
+    while (!pq.empty()) {
+        auto [d, v] = pq.top();
+        pq.pop();
+        if (d != key[v]) continue;
+        uint64_t mask = pending[v];
+        pending[v] = 0;
+        key[v] = DIST_INF;
+        int r = graph.row(v);
+        if (r < 0) continue;
+        const long long* dv = &dist[(size_t)v * count];
+        graph.forEachEdge(r, [&](int u, int w) {
+            long long* du = &dist[(size_t)u * count];
+            long long best = key[u];
+            for (uint64_t bits = mask; bits; bits &= bits - 1) {
+                int i = __builtin_ctzll(bits);
+                long long nd = dv[i] + w;
+                if (nd >= du[i]) continue;
+                du[i] = nd;
+                pending[u] |= 1ULL << i;
+                best = std::min(best, nd);
+            }
+            if (best < key[u]) {
+                key[u] = best;
+                pq.push({best, u});
+            }
+        });
+    }
+
+    for (int i = 0; i < count; ++i) {
+        int32_t* row = out + (size_t)i * n;
+        for (int v = 0; v < n; ++v) {
+            long long d = dist[(size_t)v * count + i];
+            row[v] = d == DIST_INF ? -1 : (int32_t)d;
+        }
+    }
+}
+
+void multi_source_distances(const CSRGraph& graph, const std::vector<int>& sources, DistanceMatrix& matrix) {
+    int n = graph.numVertices();
+    matrix.sources = sources;
+    matrix.num_vertices = n;
+    matrix.dist.assign(sources.size() * n, -1);
+    int batches = (sources.size() + MS_BATCH - 1) / MS_BATCH;
+    if (graph.unitWeights()) {
+        // Each batch is parallel inside
+        for (int b = 0; b < batches; ++b) {
+            int count = std::min<int>(MS_BATCH, sources.size() - b * MS_BATCH);
+            multi_source_bfs(graph, &sources[b * MS_BATCH], count, &matrix.dist[(size_t)b * MS_BATCH * n]);
+        }
+    } else {
+        // Batches are independent serial runs
+        #pragma omp parallel for schedule(dynamic, 1)
+        for (int b = 0; b < batches; ++b) {
+            int count = std::min<int>(MS_BATCH, sources.size() - b * MS_BATCH);
+            batched_dijkstra(graph, &sources[b * MS_BATCH], count, &matrix.dist[(size_t)b * MS_BATCH * n]);
+        }
+    }
+}
+
+bool read_source_list(const std::string& path, int num_vertices, std::vector<int>& sources) {
+    std::ifstream in(path);
+    if (!in) {
+        std::cerr << "Error opening source list " << path << "\n";
+        return false;
+    }
+    sources.clear();
+    long long s;
+    while (in >> s) {
+        if (s < 0 || s >= num_vertices) {
+            std::cerr << "Source " << s << " in " << path << " is not a vertex\n";
+            return false;
+        }
+        sources.push_back(s);
+    }
+    if (!in.eof()) {
+        std::cerr << "Malformed source list " << path << "\n";
+        return false;
+    }
+    return true;
+}
+
+bool write_distance_matrix(const std::string& path, const DistanceMatrix& matrix) {
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    if (!out) {
+        std::cerr << "Error creating " << path << "\n";
+        return false;
+    }
+    uint32_t version = MATRIX_VERSION;
+    uint32_t count = matrix.sources.size();
+    uint64_t n = matrix.num_vertices;
+    out.write(MATRIX_MAGIC, sizeof(MATRIX_MAGIC));
+    out.write(reinterpret_cast<const char*>(&version), sizeof(version));
+    out.write(reinterpret_cast<const char*>(&count), sizeof(count));
+    out.write(reinterpret_cast<const char*>(&n), sizeof(n));
+    std::vector<int32_t> ids(matrix.sources.begin(), matrix.sources.end());
+    out.write(reinterpret_cast<const char*>(ids.data()), ids.size() * sizeof(int32_t));
+    out.write(reinterpret_cast<const char*>(matrix.dist.data()), matrix.dist.size() * sizeof(int32_t));
+    if (!out) {
+        std::cerr << "Error writing " << path << "\n";
+        return false;
+    }
+    return true;
+}
@@ -0,0 +1,42 @@
+#pragma once
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "csr_graph.h"
+
+// Sources handled together by one multi-source pass (one bit per source in a word)
+const int MS_BATCH = 64;
+
+// Row i holds the distances from sources[i]; -1 marks unreachable vertices.
+struct DistanceMatrix {
+    std::vector<int> sources;
+    int num_vertices = 0;
+    std::vector<int32_t> dist;  // sources.size() x num_vertices, row-major
+
+    const int32_t* row(size_t i) const { return dist.data() + i * num_vertices; }
+};
+
+// Bit-parallel BFS (Then et al., MS-BFS) from up to 64 sources at once. Every vertex
+// keeps a seen word and a frontier word with one bit per source; each level a vertex
+// ORs its neighbors' frontier words, so one adjacency scan advances all sources.
+// Writes count rows of graph.numVertices() entries to out.
+void multi_source_bfs(const CSRGraph& graph, const int* sources, int count, int32_t* out);
+
+// Dijkstra for up to 64 sources sharing one queue. A vertex carries a tentative
+// distance per source plus a mask of sources whose label changed since its row was
+// last scanned; popping it relaxes all of those labels in one pass over the row.
+// Writes count rows of graph.numVertices() entries to out.
+void batched_dijkstra(const CSRGraph& graph, const int* sources, int count, int32_t* out);
+
+// Distances from every source, MS_BATCH sources at a time: bit-parallel BFS for
+// unit-weight graphs, batched Dijkstra otherwise.
+void multi_source_distances(const CSRGraph& graph, const std::vector<int>& sources, DistanceMatrix& matrix);
+
+// Whitespace-separated vertex ids; false on unreadable files or ids outside [0, num_vertices)
+bool read_source_list(const std::string& path, int num_vertices, std::vector<int>& sources);
+
+// Binary matrix file: 8-byte magic "SSSPDMAT", uint32 version, uint32 source count,
+// uint64 vertex count, int32 sources[count], then the int32 rows.
+const char MATRIX_MAGIC[8] = {'S', 'S', 'S', 'P', 'D', 'M', 'A', 'T'};
+const uint32_t MATRIX_VERSION = 1;
+bool write_distance_matrix(const std::string& path, const DistanceMatrix& matrix);
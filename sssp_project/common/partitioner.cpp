@@ -0,0 +1,164 @@
+#include "partitioner.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include "graph_io.h"
+#include "mapped_file.h"
+#include "text_parser.h"
+
+bool parse_partition_method(const std::string& name, PartitionMethod& method) {
+    if (name == "ldg") method = PartitionMethod::LDG;
+    else if (name == "fennel") method = PartitionMethod::Fennel;
+    else return false;
+    return true;
+}
+
+StreamingPartitioner::StreamingPartitioner(int num_vertices, long long num_edges, int parts, PartitionMethod method,
+                                           double slack)
+    : parts_(parts), method_(method), part_(num_vertices, -1), sizes_(parts, 0), counts_(parts, 0) {
+    capacity_ = std::max(1.0, std::ceil((1.0 + slack) * num_vertices / parts));
+    // Fennel's alpha balances the edge term against the size penalty (Tsourakakis et al.)
+    alpha_ = num_vertices > 0 ? num_edges * std::pow(parts, gamma_ - 1) / std::pow(num_vertices, gamma_) : 0.0;
+}
+
+int StreamingPartitioner::assign(int v, const int* neighbors, int degree) {
+    for (int i = 0; i < degree; ++i) {
+        int u = neighbors[i];
+        if (u < 0 || u >= (int)part_.size() || u == v) continue;
+        int p = part_[u];
+        if (p < 0) continue;
+        if (counts_[p]++ == 0) touched_.push_back(p);
+    }
+
+    int best = -1;
+    double best_score = -HUGE_VAL;
+    for (int p = 0; p < parts_; ++p) {
+        if (sizes_[p] >= capacity_) continue;
+        double score;
+        if (method_ == PartitionMethod::LDG) {
+            score = counts_[p] * (1.0 - sizes_[p] / capacity_);
+        } else {
+            score = counts_[p] - alpha_ * gamma_ * std::pow((double)sizes_[p], gamma_ - 1);
+        }
+        // Ties go to the lighter part so edgeless prefixes still spread out
+        if (score > best_score || (score == best_score && sizes_[p] < sizes_[best])) {
+            best = p;
+            best_score = score;
+        }
+    }
+    if (best < 0) best = std::min_element(sizes_.begin(), sizes_.end()) - sizes_.begin();
+
+    for (int p : touched_) {
+        edges_ += counts_[p];
+        if (p != best) cut_ += counts_[p];
+        counts_[p] = 0;
+    }
+    touched_.clear();
+
+    part_[v] = best;
+    sizes_[best]++;
+    return best;
+}
+
+PartitionStats StreamingPartitioner::stats() const {
+    PartitionStats s;
+    s.edges = edges_;
+    s.cut_edges = cut_;
+    s.part_sizes = sizes_;
+    double ideal = (double)part_.size() / parts_;
+    s.imbalance = ideal > 0 ? *std::max_element(sizes_.begin(), sizes_.end()) / ideal : 0.0;
+    return s;
+}
+
+std::vector<int> stream_partition(const CSRGraph& graph, int parts, PartitionMethod method, double slack,
+                                  PartitionStats* stats) {
+    StreamingPartitioner partitioner(graph.numVertices(), graph.numEntries() / 2, parts, method, slack);
+    std::vector<int> neighbors;
+    for (int v = 0; v < graph.numVertices(); ++v) {
+        neighbors.clear();
+        graph.forEachEdge(graph.row(v), [&](int u, int) { neighbors.push_back(u); });
+        partitioner.assign(v, neighbors.data(), neighbors.size());
+    }
+    if (stats) *stats = partitioner.stats();
+    return partitioner.partition();
+}
+
+bool stream_partition_file(const std::string& path, int parts, PartitionMethod method, double slack,
+                           std::vector<int>& part, PartitionStats* stats) {
+    if (is_binary_graph(path)) {
+        LoadedGraph loaded;
+        if (!map_binary_graph(path, loaded)) return false;
+        part = stream_partition(loaded.graph, parts, method, slack, stats);
+        return true;
+    }
+
+    // METIS text: header "n m", then line i holds the 1-based neighbors of vertex i
+    auto file = MappedFile::open(path);
+    if (!file) return false;
+    const char* p = file->data();
+    const char* end = p + file->size();
+    while (p < end && *p == '%') p = std::min(end, line_end(p, end) + 1);
+    long long n = 0, m = 0;
+    const char* q = p;
+    if (!next_int(q, end, n) || !next_int(q, end, m)) {
+        std::cerr << "Malformed header in " << path << "\n";
+        return false;
+    }
+    p = std::min(end, line_end(q, end) + 1);
+
+    StreamingPartitioner partitioner(n, m, parts, method, slack);
+    std::vector<int> neighbors;
+    long long v = 0;
+    while (p < end && v < n) {
+        const char* le = line_end(p, end);
+        if (*p != '%') {
+            neighbors.clear();
+            long long x;
+            while (next_int(p, le, x)) neighbors.push_back(x - 1);
+            partitioner.assign(v++, neighbors.data(), neighbors.size());
+        }
+        p = le + 1;
+    }
+    // Vertices without a line (truncated file) are still placed
+    for (; v < n; ++v) partitioner.assign(v, nullptr, 0);
+
+    if (stats) *stats = partitioner.stats();
+    part = partitioner.partition();
+    return true;
+}
+
+PartitionStats evaluate_partition(const CSRGraph& graph, const std::vector<int>& part, int parts) {
+    PartitionStats s;
+    s.part_sizes.assign(parts, 0);
+    for (int v = 0; v < graph.numVertices(); ++v) {
+        if (part[v] >= 0 && part[v] < parts) s.part_sizes[part[v]]++;
+        graph.forEachEdge(graph.row(v), [&](int u, int) {
+            if (u <= v) return;
+            s.edges++;
+            if (part[u] != part[v]) s.cut_edges++;
+        });
+    }
+    double ideal = (double)graph.numVertices() / parts;
+    s.imbalance = ideal > 0 ? *std::max_element(s.part_sizes.begin(), s.part_sizes.end()) / ideal : 0.0;
+    return s;
+}
+
+void print_partition_stats(const PartitionStats& stats) {
+    std::cout << "Edge cut: " << stats.cut_edges << " of " << stats.edges << " edges ("
+              << (stats.edges ? 100.0 * stats.cut_edges / stats.edges : 0.0) << "%)\n";
+    std::cout << "Part sizes:";
+    for (long long size : stats.part_sizes) std::cout << " " << size;
+    std::cout << "\nImbalance: " << stats.imbalance << "\n";
+}
+
+bool write_partition_file(const std::string& path, const std::vector<int>& part) {
+    std::ofstream out(path);
+    if (!out) {
+        std::cerr << "Error creating partition file " << path << "\n";
+        return false;
+    }
+    for (int p : part) out << p << "\n";
+    return bool(out);
+}
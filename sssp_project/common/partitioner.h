@@ -0,0 +1,64 @@
+#pragma once
+#include <string>
+#include <vector>
+#include "csr_graph.h"
+
+enum class PartitionMethod { LDG, Fennel };
+
+struct PartitionStats {
+    long long edges = 0;      // undirected edges seen
+    long long cut_edges = 0;  // edges whose endpoints landed in different parts
+    std::vector<long long> part_sizes;
+    double imbalance = 0.0;   // largest part / ideal part size
+};
+
+// Where a distributed run gets its vertex-to-rank map: a METIS-style .part file, or
+// a streaming pass over the graph at load time when no file is given.
+struct PartitionSpec {
+    std::string file;
+    PartitionMethod method = PartitionMethod::Fennel;
+    double slack = 0.05;
+};
+
+bool parse_partition_method(const std::string& name, PartitionMethod& method);
+
+// One-pass streaming partitioner. Vertices are assigned in the order they are fed,
+// each to the part that maximises its LDG or Fennel score among parts still below
+// the capacity (1 + slack) * |V| / parts. Neighbors not yet assigned are ignored, and
+// every edge is classified once, when its later endpoint arrives.
+class StreamingPartitioner {
+public:
+    StreamingPartitioner(int num_vertices, long long num_edges, int parts, PartitionMethod method,
+                         double slack = 0.05);
+
+    int assign(int v, const int* neighbors, int degree);
+
+    const std::vector<int>& partition() const { return part_; }
+    PartitionStats stats() const;
+
+private:
+    int parts_;
+    PartitionMethod method_;
+    double capacity_;
+    double alpha_;
+    double gamma_ = 1.5;
+    std::vector<int> part_;
+    std::vector<long long> sizes_;
+    std::vector<int> counts_;
+    std::vector<int> touched_;
+    long long edges_ = 0;
+    long long cut_ = 0;
+};
+
+// Streams the rows of a full-graph CSR in vertex order
+std::vector<int> stream_partition(const CSRGraph& graph, int parts, PartitionMethod method, double slack,
+                                  PartitionStats* stats = nullptr);
+
+// Streams a binary or METIS graph file straight from its mapping, one row at a time,
+// without building a CSR; memory is O(|V|) for the assignment itself.
+bool stream_partition_file(const std::string& path, int parts, PartitionMethod method, double slack,
+                           std::vector<int>& part, PartitionStats* stats = nullptr);
+
+PartitionStats evaluate_partition(const CSRGraph& graph, const std::vector<int>& part, int parts);
+void print_partition_stats(const PartitionStats& stats);
+bool write_partition_file(const std::string& path, const std::vector<int>& part);
@@ -0,0 +1,134 @@
+#include "point_to_point.h"
+#include <algorithm>
+#include <functional>
+
+PointToPoint::PointToPoint(const CSRGraph& graph) : graph_(graph) {
+    for (int side = 0; side < 2; ++side) {
+        dist_[side].assign(graph.numVertices(), DIST_INF);
+        parent_[side].assign(graph.numVertices(), -1);
+    }
+}
+
+void PointToPoint::reach(int side, int v, long long d, int p) {
+    if (dist_[side][v] == DIST_INF) touched_[side].push_back(v);
+    dist_[side][v] = d;
+    parent_[side][v] = p;
+}
+
+void PointToPoint::reset() {
+    for (int side = 0; side < 2; ++side) {
+        for (int v : touched_[side]) {
+            dist_[side][v] = DIST_INF;
+            parent_[side][v] = -1;
+        }
+        touched_[side].clear();
+        frontier_[side].clear();
+        heap_[side].clear();
+    }
+}
+
+long long PointToPoint::search(int s, int t) {
+    reset();
+    meet_ = -1;
+    settled_ = 0;
+    int n = graph_.numVertices();
+    if (s < 0 || s >= n || t < 0 || t >= n) return DIST_INF;
+    reach(0, s, 0, -1);
+    reach(1, t, 0, -1);
+    if (s == t) {
+        meet_ = s;
+        return 0;
+    }
+    return graph_.unitWeights() ? bfs(s, t) : dijkstra(s, t);
+}
+
+long long PointToPoint::bfs(int s, int t) {
+    frontier_[0].push_back(s);
+    frontier_[1].push_back(t);
+    long long level[2] = {0, 0};
+    long long best = DIST_INF;
+    while (!frontier_[0].empty() && !frontier_[1].empty()) {
+        long long edges[2] = {0, 0};
+        for (int side = 0; side < 2; ++side) {
+            for (int u : frontier_[side]) {
+                int r = graph_.row(u);
+                edges[side] += graph_.rowEnd(r) - graph_.rowBegin(r);
+            }
+        }
+        int side = edges[0] <= edges[1] ? 0 : 1;
+        int other = 1 - side;
+
+        next_.clear();
+        for (int u : frontier_[side]) {
+            ++settled_;
+            graph_.forEachEdge(graph_.row(u), [&](int v, int) {
+                if (dist_[side][v] != DIST_INF) return;
+                reach(side, v, level[side] + 1, u);
+                next_.push_back(v);
+                if (dist_[other][v] != DIST_INF && level[side] + 1 + dist_[other][v] < best) {
+                    best = level[side] + 1 + dist_[other][v];
+                    meet_ = v;
+                }
+            });
+        }
+        frontier_[side].swap(next_);
+        ++level[side];
+        // Every shorter path would have met on an earlier level
+        if (best != DIST_INF) return best;
+    }
+    return DIST_INF;
+}
+
+long long PointToPoint::dijkstra(int s, int t) {
+    auto push = [&](int side, long long d, int v) {
+        heap_[side].push_back({d, v});
+        std::push_heap(heap_[side].begin(), heap_[side].end(), std::greater<>());
+    };
+    auto pop = [&](int side) {
+        std::pop_heap(heap_[side].begin(), heap_[side].end(), std::greater<>());
+        heap_[side].pop_back();
+    };
+    push(0, 0, s);
+    push(1, 0, t);
+    long long best = DIST_INF;
+    while (true) {
+        // Drop entries superseded by a later decrease
+        for (int side = 0; side < 2; ++side) {
+            auto& h = heap_[side];
+            while (!h.empty() && h.front().first > dist_[side][h.front().second]) pop(side);
+        }
+        if (heap_[0].empty() || heap_[1].empty()) break;
+        long long top0 = heap_[0].front().first, top1 = heap_[1].front().first;
+        if (best != DIST_INF && top0 + top1 >= best) break;
+
+        int side = top0 <= top1 ? 0 : 1;
+        int other = 1 - side;
+        auto [d, u] = heap_[side].front();
+        pop(side);
+        ++settled_;
+        graph_.forEachEdge(graph_.row(u), [&](int v, int w) {
+            if (d + w < dist_[side][v]) {
+                reach(side, v, d + w, u);
+                push(side, d + w, v);
+            }
+            if (dist_[other][v] != DIST_INF && dist_[side][v] + dist_[other][v] < best) {
+                best = dist_[side][v] + dist_[other][v];
+                meet_ = v;
+            }
+        });
+    }
+    return best;
+}
+
+long long PointToPoint::distance(int s, int t) {
+    return search(s, t);
+}
+
+std::vector<int> PointToPoint::path(int s, int t) {
+    std::vector<int> out;
+    if (search(s, t) == DIST_INF) return out;
+    for (int v = meet_; v != -1; v = parent_[0][v]) out.push_back(v);
+    std::reverse(out.begin(), out.end());
+    for (int v = parent_[1][meet_]; v != -1; v = parent_[1][v]) out.push_back(v);
+    return out;
+}
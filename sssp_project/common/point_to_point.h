@@ -0,0 +1,42 @@
+#pragma once
+#include <utility>
+#include <vector>
+#include "csr_graph.h"
+
+// Point-to-point shortest paths on an undirected graph (rows cover every vertex and are
+// symmetric, as the loaders build them). A forward search from s and a backward search
+// from t run until they meet:
+//   - unit weights: bidirectional BFS, always expanding the side whose frontier has
+//     fewer edges; it stops at the end of the first level on which the sides touch.
+//   - otherwise: bidirectional Dijkstra, always advancing the side with the smaller
+//     queue head; it stops once the two heads sum to at least the best s-t distance
+//     seen so far.
+// Distance arrays and queues are kept between queries and only the entries a query
+// touched are reset, so a query costs what it explores, not O(|V|).
+class PointToPoint {
+public:
+    explicit PointToPoint(const CSRGraph& graph);
+
+    // DIST_INF if t is unreachable from s
+    long long distance(int s, int t);
+    // Vertices from s to t inclusive; empty if t is unreachable
+    std::vector<int> path(int s, int t);
+
+    long long lastSettled() const { return settled_; }  // vertices expanded by the last query
+
+private:
+    long long search(int s, int t);
+    long long bfs(int s, int t);
+    long long dijkstra(int s, int t);
+    void reach(int side, int v, long long d, int p);
+    void reset();
+
+    const CSRGraph& graph_;
+    std::vector<long long> dist_[2];
+    std::vector<int> parent_[2];
+    std::vector<int> touched_[2];
+    std::vector<int> frontier_[2], next_;
+    std::vector<std::pair<long long, int>> heap_[2];
+    int meet_ = -1;
+    long long settled_ = 0;
+};
@@ -0,0 +1,69 @@
+#include "sssp_tree.h"
+#include <algorithm>
+
+void SSSPTree::build(const std::vector<int>& parent) {
+    int n = parent.size();
+    parent_.assign(n, -1);
+    first_child_.assign(n, -1);
+    next_sibling_.assign(n, -1);
+    prev_sibling_.assign(n, -1);
+    edges_ = 0;
+    // Backwards, so every child list comes out in increasing vertex order
+    for (int v = n - 1; v >= 0; --v) link(v, parent[v]);
+}
+
+void SSSPTree::sync(const std::vector<int>& parent) {
+    for (int v = 0; v < (int)parent_.size(); ++v) {
+        if (parent[v] != parent_[v]) setParent(v, parent[v]);
+    }
+}
+
+void SSSPTree::setParent(int v, int p) {
+    if (parent_[v] == p) return;
+    unlink(v);
+    link(v, p);
+}
+
+void SSSPTree::link(int v, int p) {
+    parent_[v] = p;
+    if (p < 0 || p >= (int)parent_.size()) return;
+    prev_sibling_[v] = -1;
+    next_sibling_[v] = first_child_[p];
+    if (first_child_[p] != -1) prev_sibling_[first_child_[p]] = v;
+    first_child_[p] = v;
+    ++edges_;
+}
+
+void SSSPTree::unlink(int v) {
+    int p = parent_[v];
+    parent_[v] = -1;
+    if (p < 0 || p >= (int)parent_.size()) return;
+    if (prev_sibling_[v] != -1) next_sibling_[prev_sibling_[v]] = next_sibling_[v];
+    else first_child_[p] = next_sibling_[v];
+    if (next_sibling_[v] != -1) prev_sibling_[next_sibling_[v]] = prev_sibling_[v];
+    prev_sibling_[v] = next_sibling_[v] = -1;
+    --edges_;
+}
+
+DistributedTree::DistributedTree(int num_owned, const std::vector<int>& parent)
+    : parent_(parent), children_(num_owned) {
+    for (int v = 0; v < (int)parent.size(); ++v) {
+        if (parent[v] >= 0 && parent[v] < num_owned) children_[parent[v]].push_back(v);
+    }
+}
+
+void DistributedTree::setParent(int v, int p) {
+    int old = parent_[v];
+    if (old == p) return;
+    parent_[v] = p;
+    int owned = children_.size();
+    if (old >= 0 && old < owned) {
+        auto& list = children_[old];
+        auto it = std::find(list.begin(), list.end(), v);
+        if (it != list.end()) {
+            *it = list.back();
+            list.pop_back();
+        }
+    }
+    if (p >= 0 && p < owned) children_[p].push_back(v);
+}
@@ -0,0 +1,70 @@
+#pragma once
+#include <vector>
+#include "csr_graph.h"
+
+// Shortest-path tree of the dynamic-update phase: the parent of every vertex plus a
+// first-child / next-sibling index that is relinked whenever a parent changes. Tree-edge
+// tests are two array reads and a vertex's children are a list walk, so nothing has to
+// be rebuilt after an update.
+//
+// The drivers keep their Parent arrays; the tree mirrors them. Code that sets one parent
+// calls setParent, and code that rewrites many (a BFS or a reduction across ranks) calls
+// sync afterwards, which relinks only the vertices whose parent differs.
+class SSSPTree {
+public:
+    SSSPTree() = default;
+    explicit SSSPTree(const std::vector<int>& parent) { build(parent); }
+
+    // O(V); parent[v] == -1 for roots and unreached vertices
+    void build(const std::vector<int>& parent);
+    void sync(const std::vector<int>& parent);
+    void setParent(int v, int p);
+
+    int numVertices() const { return parent_.size(); }
+    int parent(int v) const { return parent_[v]; }
+    long long numEdges() const { return edges_; }
+
+    // Either direction of an undirected edge
+    bool isTreeEdge(int u, int v) const { return parent_[v] == u || parent_[u] == v; }
+
+    template <class F>
+    void forEachChild(int v, F&& f) const {
+        for (int c = first_child_[v]; c != -1; c = next_sibling_[c]) f(c);
+    }
+
+private:
+    void link(int v, int p);
+    void unlink(int v);
+
+    std::vector<int> parent_;
+    std::vector<int> first_child_;
+    std::vector<int> next_sibling_;
+    std::vector<int> prev_sibling_;  // -1 for a first child, so unlinking is O(1)
+    long long edges_ = 0;
+};
+
+// Tree of the MPI builds over the local ids of a VertexMap (owned vertices first, then
+// ghosts). Every local vertex keeps its parent (-1 for none or a parent this rank does
+// not hold), but only the owned ones, the vertices whose subtrees this rank walks, keep
+// children lists. A child of an owned vertex is its neighbor, so it is always local.
+class DistributedTree {
+public:
+    DistributedTree(int num_owned, const std::vector<int>& parent);
+
+    // New ghosts, without a parent
+    void resize(int num_local) { parent_.resize(num_local, -1); }
+    void setParent(int v, int p);
+
+    int parent(int v) const { return parent_[v]; }
+    bool isTreeEdge(int u, int v) const { return parent_[v] == u || parent_[u] == v; }
+
+    // v must be owned by this rank
+    template <class F>
+    void forEachChild(int v, F&& f) const {
+        for (int c : children_[v]) f(c);
+    }
+
+private:
+    std::vector<int> parent_;
+    std::vector<std::vector<int>> children_;  // by owned local id
+};
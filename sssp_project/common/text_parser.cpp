@@ -0,0 +1,202 @@
+#include "text_parser.h"
+#include <algorithm>
+#include <iostream>
+#include "mapped_file.h"
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+namespace {
+
+int parser_threads() {
+#ifdef _OPENMP
+    return omp_get_max_threads();
+#else
+    return 1;
+#endif
+}
+
+// Chunk boundaries: each chunk starts right after a newline
+std::vector<const char*> split_chunks(const char* begin, const char* end, int chunks) {
+    std::vector<const char*> bounds(chunks + 1, end);
+    bounds[0] = begin;
+    size_t len = end - begin;
+    for (int i = 1; i < chunks; ++i) {
+        const char* p = std::max(begin + len * i / chunks, bounds[i - 1]);
+        while (p < end && p > begin && p[-1] != '\n') ++p;
+        bounds[i] = p;
+    }
+    return bounds;
+}
+
+bool is_comment(const char* p, const char* end, TextFormat format) {
+    if (p >= end) return false;
+    return format == TextFormat::Metis ? *p == '%' : *p == '#';
+}
+
+} // namespace
+
+bool parse_text_edges(const std::string& path, TextFormat format, ParsedEdges& out) {
+    auto file = MappedFile::open(path);
+    if (!file) return false;
+    const char* p = file->data();
+    const char* end = p + file->size();
+
+    out.num_vertices = 0;
+    if (format == TextFormat::Metis || format == TextFormat::Edges) {
+        while (is_comment(p, end, format)) p = std::min(end, line_end(p, end) + 1);
+        long long n = 0, m = 0;
+        const char* q = p;
+        if (!next_int(q, end, n) || !next_int(q, end, m)) {
+            std::cerr << "Malformed header in " << path << "\n";
+            return false;
+        }
+        out.num_vertices = n;
+        p = std::min(end, line_end(q, end) + 1);
+    }
+
+    int chunks = parser_threads();
+    std::vector<const char*> bounds = split_chunks(p, end, chunks);
+    out.buffers.assign(chunks, {});
+
+    // METIS: vertex id of each line = number of non-comment lines before it
+    std::vector<long long> first_line(chunks + 1, 0);
+    if (format == TextFormat::Metis) {
+        #pragma omp parallel for schedule(static, 1)
+        for (int c = 0; c < chunks; ++c) {
+            long long lines = 0;
+            for (const char* s = bounds[c]; s < bounds[c + 1]; s = line_end(s, bounds[c + 1]) + 1) {
+                if (!is_comment(s, bounds[c + 1], format)) ++lines;
+            }
+            first_line[c + 1] = lines;
+        }
+        for (int c = 0; c < chunks; ++c) first_line[c + 1] += first_line[c];
+    }
+
+    int n = out.num_vertices;
+    std::vector<std::vector<long long>> raw_ids(format == TextFormat::Snap ? chunks : 0);
+
+    #pragma omp parallel for schedule(static, 1)
+    for (int c = 0; c < chunks; ++c) {
+        auto& buf = out.buffers[c];
+        const char* s = bounds[c];
+        const char* e = bounds[c + 1];
+        long long u = first_line[c];
+        while (s < e) {
+            const char* le = line_end(s, e);
+            if (!is_comment(s, le, format)) {
+                long long a, b, w = 1;
+                if (format == TextFormat::Metis) {
+                    if (u < n) {
+                        while (next_int(s, le, a)) {
+                            if (a >= 1 && a <= n) buf.push_back({(int)u, (int)(a - 1), 1});
+                        }
+                    }
+                    ++u;
+                } else if (next_int(s, le, a) && next_int(s, le, b)) {
+                    next_int(s, le, w);
+                    if (format == TextFormat::Edges) {
+                        if (a >= 0 && b >= 0 && a < n && b < n) buf.push_back({(int)a, (int)b, (int)w});
+                    } else {
+                        // Original ids kept aside until the relabeling below
+                        raw_ids[c].push_back(a);
+                        raw_ids[c].push_back(b);
+                        buf.push_back({0, 0, (int)w});
+                    }
+                }
+            }
+            s = le + 1;
+        }
+    }
+
+    if (format == TextFormat::Snap) {
+        std::vector<long long> ids;
+        for (const auto& r : raw_ids) ids.insert(ids.end(), r.begin(), r.end());
+        std::sort(ids.begin(), ids.end());
+        ids.erase(std::unique(ids.begin(), ids.end()), ids.end());
+        out.num_vertices = ids.size();
+
+        #pragma omp parallel for schedule(static, 1)
+        for (int c = 0; c < chunks; ++c) {
+            auto& buf = out.buffers[c];
+            for (size_t i = 0; i < buf.size(); ++i) {
+                buf[i].u = std::lower_bound(ids.begin(), ids.end(), raw_ids[c][2 * i]) - ids.begin();
+                buf[i].v = std::lower_bound(ids.begin(), ids.end(), raw_ids[c][2 * i + 1]) - ids.begin();
+            }
+            std::vector<long long>().swap(raw_ids[c]);
+        }
+    }
+    return true;
+}
+
+CSRGraph build_undirected_csr(ParsedEdges& parsed) {
+    int n = parsed.num_vertices;
+    int chunks = parsed.buffers.size();
+
+    // Degree count over both directions of every non-loop edge
+    std::vector<long long> counts(n + 1, 0);
+    #pragma omp parallel for schedule(static, 1)
+    for (int c = 0; c < chunks; ++c) {
+        for (const ParsedEdge& e : parsed.buffers[c]) {
+            if (e.u == e.v) continue;
+            #pragma omp atomic
+            counts[e.u + 1]++;
+            #pragma omp atomic
+            counts[e.v + 1]++;
+        }
+    }
+    for (int v = 0; v < n; ++v) counts[v + 1] += counts[v];
+
+    std::vector<long long> cursor(counts.begin(), counts.end() - 1);
+    std::vector<int> adj(counts[n]);
+    std::vector<int> wts(counts[n]);
+    #pragma omp parallel for schedule(static, 1)
+    for (int c = 0; c < chunks; ++c) {
+        for (const ParsedEdge& e : parsed.buffers[c]) {
+            if (e.u == e.v) continue;
+            long long a, b;
+            #pragma omp atomic capture
+            a = cursor[e.u]++;
+            #pragma omp atomic capture
+            b = cursor[e.v]++;
+            adj[a] = e.v;
+            wts[a] = e.w;
+            adj[b] = e.u;
+            wts[b] = e.w;
+        }
+        std::vector<ParsedEdge>().swap(parsed.buffers[c]);
+    }
+
+    // Per-row sort-and-unique, then compact rows to their deduplicated length
+    std::vector<long long> offsets(n + 1, 0);
+    #pragma omp parallel
+    {
+        std::vector<std::pair<int, int>> row;
+        #pragma omp for schedule(dynamic, 256)
+        for (int v = 0; v < n; ++v) {
+            row.clear();
+            for (long long i = counts[v]; i < counts[v + 1]; ++i) row.push_back({adj[i], wts[i]});
+            std::sort(row.begin(), row.end());
+            long long k = counts[v];
+            for (size_t i = 0; i < row.size(); ++i) {
+                if (i > 0 && row[i].first == row[i - 1].first) continue;
+                adj[k] = row[i].first;
+                wts[k] = row[i].second;
+                ++k;
+            }
+            offsets[v + 1] = k - counts[v];
+        }
+    }
+    for (int v = 0; v < n; ++v) offsets[v + 1] += offsets[v];
+
+    std::vector<int> final_adj(offsets[n]);
+    std::vector<int> final_wts(offsets[n]);
+    #pragma omp parallel for schedule(dynamic, 256)
+    for (int v = 0; v < n; ++v) {
+        std::copy(adj.begin() + counts[v], adj.begin() + counts[v] + (offsets[v + 1] - offsets[v]),
+                  final_adj.begin() + offsets[v]);
+        std::copy(wts.begin() + counts[v], wts.begin() + counts[v] + (offsets[v + 1] - offsets[v]),
+                  final_wts.begin() + offsets[v]);
+    }
+    return CSRGraph::fromCSR(n, std::move(offsets), std::move(final_adj), std::move(final_wts));
+}
@@ -0,0 +1,45 @@
+#pragma once
+#include <cstring>
+#include <string>
+#include <vector>
+#include "csr_graph.h"
+#include "graph_io.h"
+
+struct ParsedEdge {
+    int u;
+    int v;
+    int w;
+};
+
+// Edges parsed from a text graph, one buffer per parser thread
+struct ParsedEdges {
+    int num_vertices = 0;
+    std::vector<std::vector<ParsedEdge>> buffers;
+};
+
+// Parses the next integer on the current line; returns false at end of line
+inline bool next_int(const char*& p, const char* end, long long& value) {
+    while (p < end && *p != '\n' && (*p < '0' || *p > '9') && *p != '-') ++p;
+    if (p >= end || *p == '\n') return false;
+    bool neg = *p == '-';
+    if (neg) ++p;
+    long long x = 0;
+    while (p < end && *p >= '0' && *p <= '9') x = x * 10 + (*p++ - '0');
+    value = neg ? -x : x;
+    return true;
+}
+
+inline const char* line_end(const char* p, const char* end) {
+    const char* nl = static_cast<const char*>(std::memchr(p, '\n', end - p));
+    return nl ? nl : end;
+}
+
+// Splits the file into byte ranges at newline boundaries and parses them in parallel.
+// METIS line numbers are recovered with a per-chunk line count and a prefix sum; SNAP
+// ids are relabeled to 0..n-1 in ascending order of the original id.
+bool parse_text_edges(const std::string& path, TextFormat format, ParsedEdges& out);
+
+// Symmetrizes the parsed edges and builds the CSR directly: parallel degree count,
+// scatter, then a per-row sort-and-unique that drops self-loops and keeps the lightest
+// duplicate.
+CSRGraph build_undirected_csr(ParsedEdges& parsed);
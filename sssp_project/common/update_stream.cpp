@@ -0,0 +1,154 @@
+#include "update_stream.h"
+#include <algorithm>
+#include <cstring>
+#include <iostream>
+#include <sstream>
+#include <unordered_map>
+
+bool UpdateStream::open(const std::string& path, int num_vertices) {
+    in_.close();
+    in_.clear();
+    in_.open(path, std::ios::binary);
+    path_ = path;
+    num_vertices_ = num_vertices;
+    failed_ = false;
+    consumed_ = 0;
+    line_ = 0;
+    if (!in_) {
+        std::cerr << "Error opening update stream " << path << "\n";
+        failed_ = true;
+        return false;
+    }
+
+    char magic[8] = {};
+    in_.read(magic, sizeof(magic));
+    binary_ = in_.gcount() == sizeof(magic) && std::memcmp(magic, UPDATE_MAGIC, sizeof(magic)) == 0;
+    if (!binary_) {
+        in_.clear();
+        in_.seekg(0);
+        return true;
+    }
+    uint32_t version, reserved;
+    in_.read(reinterpret_cast<char*>(&version), sizeof(version));
+    in_.read(reinterpret_cast<char*>(&reserved), sizeof(reserved));
+    in_.read(reinterpret_cast<char*>(&remaining_), sizeof(remaining_));
+    if (!in_ || version != UPDATE_VERSION) {
+        std::cerr << "Update stream " << path << " has an unknown format or version\n";
+        failed_ = true;
+        return false;
+    }
+    return true;
+}
+
+bool UpdateStream::valid(const EdgeUpdate& e) {
+    if (e.u < 0 || e.u >= num_vertices_ || e.v < 0 || e.v >= num_vertices_ || e.w < 0 ||
+        (e.kind != UpdateKind::Insert && e.kind != UpdateKind::Delete && e.kind != UpdateKind::Weight)) {
+        std::cerr << "Invalid update record " << consumed_ + 1 << " in " << path_ << "\n";
+        failed_ = true;
+        return false;
+    }
+    return true;
+}
+
+bool UpdateStream::next(size_t max, std::vector<EdgeUpdate>& batch) {
+    batch.clear();
+    if (failed_ || !in_.is_open()) return false;
+
+    if (binary_) {
+        size_t count = std::min<uint64_t>(max, remaining_);
+        std::vector<int32_t> raw(count * 4);
+        in_.read(reinterpret_cast<char*>(raw.data()), raw.size() * sizeof(int32_t));
+        if (!in_) {
+            std::cerr << "Update stream " << path_ << " is truncated\n";
+            failed_ = true;
+            return false;
+        }
+        remaining_ -= count;
+        for (size_t i = 0; i < count; ++i) {
+            EdgeUpdate e = {static_cast<UpdateKind>(raw[i * 4]), raw[i * 4 + 1], raw[i * 4 + 2], raw[i * 4 + 3]};
+            if (!valid(e)) return false;
+            batch.push_back(e);
+            ++consumed_;
+        }
+        return !batch.empty();
+    }
+
+    std::string line;
+    while (batch.size() < max && std::getline(in_, line)) {
+        ++line_;
+        size_t hash = line.find('#');
+        if (hash != std::string::npos) line.resize(hash);
+        std::istringstream fields(line);
+        char op;
+        if (!(fields >> op)) continue;
+        EdgeUpdate e = {UpdateKind::Insert, -1, -1, 1};
+        bool ok = bool(fields >> e.u >> e.v);
+        if (op == '+') {
+            if (!(fields >> e.w)) e.w = 1;
+        } else if (op == '-') {
+            e.kind = UpdateKind::Delete;
+        } else if (op == '=') {
+            e.kind = UpdateKind::Weight;
+            ok = ok && bool(fields >> e.w);
+        } else {
+            ok = false;
+        }
+        if (!ok) {
+            std::cerr << "Malformed update on line " << line_ << " of " << path_ << "\n";
+            failed_ = true;
+            return false;
+        }
+        if (!valid(e)) return false;
+        batch.push_back(e);
+        ++consumed_;
+    }
+    return !batch.empty();
+}
+
+void split_updates(const std::vector<EdgeUpdate>& batch, std::vector<std::pair<int, int>>& deletions,
+                   std::vector<std::tuple<int, int, int>>& insertions) {
+    deletions.clear();
+    insertions.clear();
+    std::unordered_map<long long, size_t> last;
+    last.reserve(batch.size());
+    auto key = [](const EdgeUpdate& e) {
+        return (long long)std::min(e.u, e.v) << 32 | (unsigned)std::max(e.u, e.v);
+    };
+    for (size_t i = 0; i < batch.size(); ++i) last[key(batch[i])] = i;
+    for (size_t i = 0; i < batch.size(); ++i) {
+        const EdgeUpdate& e = batch[i];
+        if (e.u == e.v || last[key(e)] != i) continue;
+        deletions.push_back({e.u, e.v});
+        if (e.kind != UpdateKind::Delete) insertions.emplace_back(e.u, e.v, e.w);
+    }
+}
+
+bool write_update_stream(const std::string& path, const std::vector<EdgeUpdate>& updates, bool binary) {
+    std::ofstream out(path, binary ? std::ios::binary : std::ios::out);
+    if (!out) {
+        std::cerr << "Error opening " << path << " for writing\n";
+        return false;
+    }
+    if (binary) {
+        uint32_t version = UPDATE_VERSION, reserved = 0;
+        uint64_t count = updates.size();
+        out.write(UPDATE_MAGIC, sizeof(UPDATE_MAGIC));
+        out.write(reinterpret_cast<const char*>(&version), sizeof(version));
+        out.write(reinterpret_cast<const char*>(&reserved), sizeof(reserved));
+        out.write(reinterpret_cast<const char*>(&count), sizeof(count));
+        for (const EdgeUpdate& e : updates) {
+            int32_t raw[4] = {static_cast<int32_t>(e.kind), e.u, e.v, e.w};
+            out.write(reinterpret_cast<const char*>(raw), sizeof(raw));
+        }
+    } else {
+        for (const EdgeUpdate& e : updates) {
+            if (e.kind == UpdateKind::Delete) out << "- " << e.u << " " << e.v << "\n";
+            else out << (e.kind == UpdateKind::Insert ? "+ " : "= ") << e.u << " " << e.v << " " << e.w << "\n";
+        }
+    }
+    if (!out) {
+        std::cerr << "Error writing " << path << "\n";
+        return false;
+    }
+    return true;
+}
@@ -0,0 +1,58 @@
+#pragma once
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+// Edge update log read in batches by the dynamic-update drivers. Edges are undirected.
+//
+// Text: one record per line, '#' starts a comment
+//   + u v [w]   insert (u, v) with weight w (default 1); an existing edge takes the new weight
+//   - u v       delete (u, v)
+//   = u v w     change the weight of (u, v) to w
+// Binary: 8-byte magic "SSSPUPDS", uint32 version, uint32 reserved, uint64 record count,
+// then records of four int32 (kind, u, v, w).
+enum class UpdateKind : int32_t { Insert = 0, Delete = 1, Weight = 2 };
+
+struct EdgeUpdate {
+    UpdateKind kind;
+    int u, v, w;
+};
+
+const char UPDATE_MAGIC[8] = {'S', 'S', 'S', 'P', 'U', 'P', 'D', 'S'};
+const uint32_t UPDATE_VERSION = 1;
+
+class UpdateStream {
+public:
+    // Detects the format from the magic; vertex ids must lie in [0, num_vertices)
+    bool open(const std::string& path, int num_vertices);
+
+    // Replaces batch with the next max records. False once the stream is exhausted or a
+    // record is malformed (failed() tells the two apart).
+    bool next(size_t max, std::vector<EdgeUpdate>& batch);
+    bool failed() const { return failed_; }
+    long long consumed() const { return consumed_; }
+
+private:
+    bool valid(const EdgeUpdate& e);
+
+    std::ifstream in_;
+    std::string path_;
+    bool binary_ = false;
+    uint64_t remaining_ = 0;  // binary records left
+    long long line_ = 0;
+    int num_vertices_ = 0;
+    bool failed_ = false;
+    long long consumed_ = 0;
+};
+
+// Turns a batch into the deletion and insertion lists ProcessCE takes. Only the last
+// record for an edge counts; an insert or weight change deletes the old edge first, so
+// a tree edge whose weight changes has its subtree invalidated like a deletion.
+void split_updates(const std::vector<EdgeUpdate>& batch, std::vector<std::pair<int, int>>& deletions,
+                   std::vector<std::tuple<int, int, int>>& insertions);
+
+// Writes updates in the text or binary format UpdateStream reads
+bool write_update_stream(const std::string& path, const std::vector<EdgeUpdate>& updates, bool binary);
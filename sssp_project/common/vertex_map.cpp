@@ -0,0 +1,88 @@
+#include "vertex_map.h"
+#include <algorithm>
+#include "dist_loader.h"
+
+VertexMap::VertexMap(const CSRGraph& graph, MPI_Comm comm)
+    : comm_(comm), num_vertices_(graph.numVertices()), num_owned_(graph.localVertices.size()) {
+    MPI_Comm_rank(comm, &rank_);
+    MPI_Comm_size(comm, &nprocs_);
+    block_ = std::max(1, (num_vertices_ + nprocs_ - 1) / nprocs_);
+
+    global_ = graph.localVertices;
+    rows_.reserve(num_owned_);
+    local_.reserve(num_owned_);
+    for (int l = 0; l < num_owned_; ++l) {
+        rows_.push_back(graph.row(global_[l]));
+        local_.emplace(global_[l], l);
+    }
+
+    // Every owner registers its vertices with their directory rank
+    std::vector<std::vector<int>> out(nprocs_);
+    for (int v : global_) out[directoryRank(v)].insert(out[directoryRank(v)].end(), {v, rank_});
+    std::vector<int> in = alltoallv(out, comm);
+    directory_.assign(block_, -1);
+    for (size_t i = 0; i < in.size(); i += 2) directory_[in[i] - rank_ * block_] = in[i + 1];
+
+    std::vector<int> neighbors;
+    for (int l = 0; l < num_owned_; ++l) {
+        graph.forEachEdge(rows_[l], [&](int n, long long) {
+            if (local(n) < 0) neighbors.push_back(n);
+        });
+    }
+    std::sort(neighbors.begin(), neighbors.end());
+    neighbors.erase(std::unique(neighbors.begin(), neighbors.end()), neighbors.end());
+    addGhosts(neighbors);
+}
+
+int VertexMap::addGhosts(const std::vector<int>& vertices) {
+    // Ask the directory for the owners of the ones not held yet, then add the answers
+    std::vector<std::vector<int>> out(nprocs_);
+    for (int v : vertices) {
+        if (v < 0 || v >= num_vertices_ || local(v) >= 0) continue;
+        out[directoryRank(v)].insert(out[directoryRank(v)].end(), {v, rank_});
+    }
+    std::vector<int> in = alltoallv(out, comm_);
+    for (auto& o : out) o.clear();
+    for (size_t i = 0; i < in.size(); i += 2) {
+        int v = in[i], requester = in[i + 1];
+        out[requester].insert(out[requester].end(), {v, directory_[v - rank_ * block_]});
+    }
+    in = alltoallv(out, comm_);
+
+    int added = 0;
+    for (size_t i = 0; i < in.size(); i += 2) {
+        int v = in[i], o = in[i + 1];
+        if (o < 0 || o == rank_ || local(v) >= 0) continue;
+        local_.emplace(v, global_.size());
+        global_.push_back(v);
+        ghost_owner_.push_back(o);
+        ++added;
+    }
+    return added;
+}
+
+std::vector<long long> gather_owned(const VertexMap& map, const std::vector<long long>& values, long long fill,
+                                    int root, MPI_Comm comm) {
+    int rank, nprocs;
+    MPI_Comm_rank(comm, &rank);
+    MPI_Comm_size(comm, &nprocs);
+    int count = map.numOwned();
+    std::vector<int> ids(count);
+    for (int l = 0; l < count; ++l) ids[l] = map.global(l);
+
+    std::vector<int> counts(nprocs), displs(nprocs, 0);
+    MPI_Gather(&count, 1, MPI_INT, counts.data(), 1, MPI_INT, root, comm);
+    for (int r = 1; r < nprocs; ++r) displs[r] = displs[r - 1] + counts[r - 1];
+    int total = rank == root ? displs[nprocs - 1] + counts[nprocs - 1] : 0;
+    std::vector<int> all_ids(total);
+    std::vector<long long> all_values(total);
+    MPI_Gatherv(ids.data(), count, MPI_INT, all_ids.data(), counts.data(), displs.data(), MPI_INT, root, comm);
+    MPI_Gatherv(values.data(), count, MPI_LONG_LONG, all_values.data(), counts.data(), displs.data(), MPI_LONG_LONG,
+                root, comm);
+
+    std::vector<long long> full;
+    if (rank != root) return full;
+    full.assign(map.numVertices(), fill);
+    for (int i = 0; i < total; ++i) full[all_ids[i]] = all_values[i];
+    return full;
+}
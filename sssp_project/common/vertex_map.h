@@ -0,0 +1,55 @@
+#pragma once
+#include <unordered_map>
+#include <vector>
+#include <mpi.h>
+#include "csr_graph.h"
+
+// Local numbering of the vertices one rank works on: the owned vertices first, in the
+// order of graph.localVertices, then the ghosts, neighbors owned by another rank, in the
+// order they became known. An owned vertex's CSR row is row(l); it equals l for a graph
+// holding only the owned rows, but not for a mapped graph that holds every row. Per-vertex state sized by size() costs O(V/p) plus the
+// boundary instead of the global vertex count.
+//
+// Owners of vertices outside the map come from a directory spread over the ranks in
+// blocks of ceil(V/p) ids, so no rank holds a |V|-sized table.
+class VertexMap {
+public:
+    // Collective. The owned vertices are graph.localVertices, the ghosts their neighbors
+    // held elsewhere.
+    VertexMap(const CSRGraph& graph, MPI_Comm comm);
+
+    int numVertices() const { return num_vertices_; }  // global count
+    int numOwned() const { return num_owned_; }
+    int size() const { return global_.size(); }
+
+    // -1 for a vertex this rank does not hold
+    int local(int v) const {
+        auto it = local_.find(v);
+        return it == local_.end() ? -1 : it->second;
+    }
+    int global(int l) const { return global_[l]; }
+    bool owned(int l) const { return l < num_owned_; }
+    int row(int l) const { return rows_[l]; }  // owned l only
+    int owner(int l) const { return l < num_owned_ ? rank_ : ghost_owner_[l - num_owned_]; }
+
+    // Collective. Adds the vertices this rank does not hold yet as ghosts, skipping ids
+    // nobody owns; returns how many were added.
+    int addGhosts(const std::vector<int>& vertices);
+
+private:
+    int directoryRank(int v) const { return v / block_; }
+
+    MPI_Comm comm_;
+    int rank_, nprocs_;
+    int num_vertices_, num_owned_, block_;
+    std::vector<int> global_;
+    std::vector<int> rows_;  // CSR row by owned local id
+    std::vector<int> ghost_owner_;
+    std::unordered_map<int, int> local_;
+    std::vector<int> directory_;  // owners of ids [rank * block_, (rank + 1) * block_)
+};
+
+// Collective. The values of the owned vertices (by local id) assembled on root into an
+// array by global id, fill where nobody reported; empty on the other ranks.
+std::vector<long long> gather_owned(const VertexMap& map, const std::vector<long long>& values, long long fill,
+                                    int root, MPI_Comm comm);
@@ -0,0 +1,127 @@
+#include "workload.h"
+#include <algorithm>
+#include <cstdio>
+#include <iostream>
+
+bool parse_workload_spec(const CommandLine& cli, WorkloadSpec& spec) {
+    spec.seed = cli.getInt("seed", 1);
+    std::string mix = cli.get("mix", "1:1:0");
+    char tail;
+    int fields = std::sscanf(mix.c_str(), "%d:%d:%d%c", &spec.insert_share, &spec.delete_share,
+                             &spec.weight_share, &tail);
+    if (fields == 2) spec.weight_share = 0;
+    if ((fields != 2 && fields != 3) || spec.insert_share < 0 || spec.delete_share < 0 || spec.weight_share < 0 ||
+        spec.insert_share + spec.delete_share + spec.weight_share == 0) {
+        std::cerr << "Invalid --mix " << mix << ", expected inserts:deletes[:weight changes]\n";
+        return false;
+    }
+    spec.tree_deletions = cli.getDouble("tree-deletions", 1.0);
+    spec.locality = cli.getDouble("locality", 0.0);
+    spec.hub_bias = cli.getDouble("hub-bias", 0.0);
+    spec.max_weight = cli.getInt("max-weight", 1);
+    for (double f : {spec.tree_deletions, spec.locality, spec.hub_bias}) {
+        if (f < 0 || f > 1) {
+            std::cerr << "--tree-deletions, --locality and --hub-bias must lie in [0, 1]\n";
+            return false;
+        }
+    }
+    if (spec.max_weight < 1) {
+        std::cerr << "--max-weight must be at least 1\n";
+        return false;
+    }
+    return true;
+}
+
+WorkloadGenerator::WorkloadGenerator(const CSRGraph& graph, const WorkloadSpec& spec, uint64_t stream)
+    : graph_(graph), spec_(spec), rng_(spec.seed ^ stream * 0x9E3779B97F4A7C15ULL) {}
+
+// Rows of owned vertices only: a mapped graph holds every row, but each rank draws its
+// share from the vertices it owns
+int WorkloadGenerator::randomRow() {
+    const std::vector<int>& owned = graph_.localVertices;
+    if (graph_.numEntries() > 0 && chance(spec_.hub_bias)) {
+        // A uniform entry of the owned rows falls in a row with probability proportional to its degree
+        if (ownedEntries_.empty() || ownedEntriesAt_ != graph_.numEntries()) {
+            ownedEntries_.assign(owned.size() + 1, 0);
+            for (size_t k = 0; k < owned.size(); ++k) {
+                int r = graph_.row(owned[k]);
+                ownedEntries_[k + 1] = ownedEntries_[k] + graph_.rowEnd(r) - graph_.rowBegin(r);
+            }
+            ownedEntriesAt_ = graph_.numEntries();
+        }
+        if (ownedEntries_.back() > 0) {
+            long long i = std::uniform_int_distribution<long long>(0, ownedEntries_.back() - 1)(rng_);
+            size_t k = std::upper_bound(ownedEntries_.begin(), ownedEntries_.end(), i) - ownedEntries_.begin() - 1;
+            return graph_.row(owned[k]);
+        }
+    }
+    return graph_.row(owned[std::uniform_int_distribution<int>(0, owned.size() - 1)(rng_)]);
+}
+
+// Samples the CSR entries only, so edges inserted since the last compaction are never
+// picked; -1 for an empty row or a deleted entry
+int WorkloadGenerator::randomNeighbor(int r) {
+    long long begin = graph_.rowBegin(r), end = graph_.rowEnd(r);
+    if (begin == end) return -1;
+    long long i = std::uniform_int_distribution<long long>(begin, end - 1)(rng_);
+    return graph_.removed(i) ? -1 : graph_.dest(i);
+}
+
+int WorkloadGenerator::randomWeight() {
+    return std::uniform_int_distribution<int>(1, spec_.max_weight)(rng_);
+}
+
+// Every tree edge is (parent[v], v) for exactly one v, so sampling the child side
+// reaches each once
+bool WorkloadGenerator::pickTreeEdge(const std::function<int(int)>& parent, int& u, int& v) {
+    int r = randomRow();
+    v = graph_.vertex(r);
+    u = parent(v);
+    return u >= 0 && graph_.hasEdge(r, u);
+}
+
+bool WorkloadGenerator::pickNonTreeEdge(const std::function<int(int)>& parent, int& u, int& v) {
+    int r = randomRow();
+    u = graph_.vertex(r);
+    v = randomNeighbor(r);
+    return v >= 0 && parent(v) != u && parent(u) != v;
+}
+
+// u comes from a local row (degree-biased with hub_bias, so hubs attract new edges);
+// v is a neighbor's neighbor with probability locality, otherwise any vertex
+bool WorkloadGenerator::pickNewEdge(int& u, int& v) {
+    int r = randomRow();
+    u = graph_.vertex(r);
+    v = -1;
+    if (chance(spec_.locality)) {
+        int w = randomNeighbor(r);
+        int rw = graph_.row(w);
+        if (rw >= 0) v = randomNeighbor(rw);
+    }
+    if (v < 0) v = std::uniform_int_distribution<int>(0, graph_.numVertices() - 1)(rng_);
+    return v != u && !graph_.hasEdge(r, v);
+}
+
+void WorkloadGenerator::generate(size_t count, const std::function<int(int)>& parent,
+                                 std::vector<EdgeUpdate>& batch) {
+    if (graph_.localVertices.empty()) return;
+    int total = spec_.insert_share + spec_.delete_share + spec_.weight_share;
+    std::uniform_int_distribution<int> kinds(0, total - 1);
+    for (size_t k = 0; k < count; ++k) {
+        int pick = kinds(rng_);
+        EdgeUpdate e = {UpdateKind::Insert, -1, -1, 1};
+        if (pick >= spec_.insert_share) {
+            e.kind = pick < spec_.insert_share + spec_.delete_share ? UpdateKind::Delete : UpdateKind::Weight;
+        }
+        bool tree = e.kind != UpdateKind::Insert && chance(spec_.tree_deletions);
+        for (int t = 0; t < WORKLOAD_MAX_TRIES; ++t) {
+            bool found = e.kind == UpdateKind::Insert ? pickNewEdge(e.u, e.v)
+                         : tree                       ? pickTreeEdge(parent, e.u, e.v)
+                                                      : pickNonTreeEdge(parent, e.u, e.v);
+            if (!found) continue;
+            if (e.kind != UpdateKind::Delete) e.w = randomWeight();
+            batch.push_back(e);
+            break;
+        }
+    }
+}
@@ -0,0 +1,62 @@
+#pragma once
+#include <cstdint>
+#include <functional>
+#include <random>
+#include <vector>
+#include "cli.h"
+#include "csr_graph.h"
+#include "update_stream.h"
+
+// Attempts per update before the generator gives up on it (e.g. a deletion in a graph
+// with no edges left); the batch then comes out short
+const int WORKLOAD_MAX_TRIES = 16;
+
+// Mix of a synthetic update batch. Kinds are drawn in proportion to the three weights;
+// the fractions are probabilities per update.
+struct WorkloadSpec {
+    uint64_t seed = 1;
+    int insert_share = 1;
+    int delete_share = 1;
+    int weight_share = 0;
+    double tree_deletions = 1.0;  // deletions (and weight changes) that hit an SSSP tree edge
+    double locality = 0.0;        // insertions that close a triangle instead of joining random vertices
+    double hub_bias = 0.0;        // endpoints drawn in proportion to degree instead of uniformly
+    int max_weight = 1;           // new weights are uniform in [1, max_weight]
+};
+
+// --seed N --mix I:D:W --tree-deletions F --locality F --hub-bias F --max-weight W
+bool parse_workload_spec(const CommandLine& cli, WorkloadSpec& spec);
+
+// Draws reproducible update batches against the current graph, in O(1) expected work per
+// update: endpoints are sampled straight from the CSR rows and rejected if unsuitable,
+// instead of searching the graph for a candidate.
+//
+// Only the rows of graph.localVertices are sampled, so on a distributed graph (partitioned
+// or mapped whole) every rank generates its share from its own vertices (give each rank
+// its own stream) and the shares are concatenated. The tree is read through parent(v)
+// (-1 for none), which is only asked about those vertices and their neighbors.
+class WorkloadGenerator {
+public:
+    WorkloadGenerator(const CSRGraph& graph, const WorkloadSpec& spec, uint64_t stream = 0);
+
+    // Appends up to count updates to batch
+    void generate(size_t count, const std::function<int(int)>& parent, std::vector<EdgeUpdate>& batch);
+    void generate(size_t count, const std::vector<int>& parent, std::vector<EdgeUpdate>& batch) {
+        generate(count, [&](int v) { return parent[v]; }, batch);
+    }
+
+private:
+    int randomRow();
+    int randomNeighbor(int r);
+    int randomWeight();
+    bool pickTreeEdge(const std::function<int(int)>& parent, int& u, int& v);
+    bool pickNonTreeEdge(const std::function<int(int)>& parent, int& u, int& v);
+    bool pickNewEdge(int& u, int& v);
+    bool chance(double p) { return p > 0 && std::uniform_real_distribution<double>(0, 1)(rng_) < p; }
+
+    const CSRGraph& graph_;
+    WorkloadSpec spec_;
+    std::mt19937_64 rng_;
+    std::vector<long long> ownedEntries_;  // entry-count prefix over the owned rows, for hub_bias
+    long long ownedEntriesAt_ = -1;        // numEntries() when it was built; compaction changes it
+};
@@ -1,16 +1,12 @@
 #pragma once
 #include <vector>
 #include <string>
-#include <unordered_map>
+#include "csr_graph.h"
+#include "partitioner.h"
 
-struct Edge {
-    int dest;
-    long long weight;
-};
+using Graph = CSRGraph;
 
-struct Graph {
-    std::unordered_map<int, std::vector<Edge>> adjacencyList;
-    std::vector<int> localVertices;
-};
-
-Graph load_partitioned_graph(const std::string& graphFile, const std::string& partFile, int rank);
+// Collective. By default each rank reads only its own rows with MPI-IO; with
+// mapWholeGraph a binary graph is instead mapped in full and shared through the page cache.
+Graph load_partitioned_graph(const std::string& graphFile, const PartitionSpec& spec, int rank,
+                             bool mapWholeGraph = false);
@@ -2,7 +2,6 @@
 #include <omp.h>
 #include <iostream>
 #include <vector>
-#include <set>
 #include <tuple>
 #include <limits>
 #include <fstream>
@@ -11,6 +10,19 @@
 #include <algorithm>
 #include "sssp_mpi.h"
 #include "graph_loader.h"
+#include "cli.h"
+#include "delta_stepping.h"
+#include "dijkstra.h"
+#include "graph_io.h"
+#include "dist_delta_stepping.h"
+#include "dist_bfs.h"
+#include "dist_loader.h"
+#include "update_stream.h"
+#include "workload.h"
+#include "distance_store.h"
+#include "vertex_map.h"
+#include "atomic_label.h"
+#include <memory>
 
 int main(int argc, char** argv) {
     MPI_Init(&argc, &argv);
@@ -26,258 +38,222 @@ int main(int argc, char** argv) {
         }
     }
 
-    std::string graphFile = "/mirror/facebook_graph.txt";
-    std::string partFile = "/mirror/facebook_graph.txt.part.8";
-    if (rank == 0) std::cout << "Rank " << rank << ": Reading graph from " << graphFile << ", partition from " << partFile << "\n";
-    Graph graph = load_partitioned_graph(graphFile, partFile, rank);
+    CommandLine cli(argc, argv);
+    std::string graphFile = cli.get("graph", "/mirror/facebook_graph.txt");
+    // Without --part the partition is computed at load time for the current rank count
+    PartitionSpec spec;
+    spec.file = cli.get("part", "");
+    spec.slack = cli.getDouble("slack", spec.slack);
+    if (!parse_partition_method(cli.get("partitioner", "fennel"), spec.method)) {
+        if (rank == 0) std::cerr << "Unknown partitioner " << cli.get("partitioner", "") << "\n";
+        MPI_Abort(MPI_COMM_WORLD, 1);
+    }
+    QueueKind queue_kind;
+    if (!parse_queue_kind(cli.get("queue", "radix"), queue_kind)) {
+        if (rank == 0) std::cerr << "Unknown queue " << cli.get("queue", "") << "\n";
+        MPI_Abort(MPI_COMM_WORLD, 1);
+    }
+    if (rank == 0) std::cout << "Rank " << rank << ": Reading graph from " << graphFile << ", partition from "
+              << (spec.file.empty() ? cli.get("partitioner", "fennel") : spec.file) << "\n";
+    Graph graph = load_partitioned_graph(graphFile, spec, rank, cli.has("mmap"));
 
-    int num_vertices = 0;
-    if (rank == 0) {
-        std::ifstream pfile(partFile);
-        if (!pfile) {
-            std::cerr << "Rank " << rank << ": Error opening partition file " << partFile << "\n";
-            MPI_Abort(MPI_COMM_WORLD, 1);
-        }
-        std::string line;
-        while (std::getline(pfile, line)) {
-            if (!line.empty()) num_vertices++;
-        }
-        pfile.close();
-        std::cout << "Rank " << rank << ": num_vertices = " << num_vertices << "\n";
+    int num_vertices = graph.numVertices();
+    if (num_vertices == 0) {
+        std::cerr << "Rank " << rank << ": Error loading graph " << graphFile << "\n";
+        MPI_Abort(MPI_COMM_WORLD, 1);
     }
-    MPI_Bcast(&num_vertices, 1, MPI_INT, 0, MPI_COMM_WORLD);
+    if (rank == 0) std::cout << "Rank " << rank << ": num_vertices = " << num_vertices << "\n";
 
     const long long INF = std::numeric_limits<long long>::max();
     std::vector<long long> Dist(num_vertices, INF);
     std::vector<int> Parent(num_vertices, -1);
-    std::vector<int> AffectedDel(num_vertices, 0);
-    std::vector<int> Affected(num_vertices, 0);
     std::vector<std::tuple<int, int, int>> Gu;
-    std::set<std::pair<int, int>> Tree;
 
-    // Sequential Dijkstra
-    auto start_seq = std::chrono::high_resolution_clock::now();
+    // Sequential Dijkstra on rank 0 (--queue binary|radix|dial), kept as the timing
+    // reference for the parallel phase. The partitioned graph holds only rank 0's rows,
+    // so with more than one rank the reference runs on the whole graph, loaded untimed.
+    double seq_time = 0;
     if (rank == 0) {
-        Dist[0] = 0;
-        std::priority_queue<std::pair<long long, int>, std::vector<std::pair<long long, int>>, std::greater<>> pq;
-        pq.push({0, 0});
-        std::vector<bool> visited(num_vertices, false);
-        while (!pq.empty()) {
-            int u = pq.top().second;
-            long long d = pq.top().first;
-            pq.pop();
-            if (visited[u]) continue;
-            visited[u] = true;
-            auto it = graph.adjacencyList.find(u);
-            if (it != graph.adjacencyList.end()) {
-                for (const auto& edge : it->second) {
-                    int v = edge.dest;
-                    long long w = edge.weight;
-                    if (v >= 0 && v < num_vertices && !visited[v] && Dist[v] > Dist[u] + w) {
-                        Dist[v] = Dist[u] + w;
-                        Parent[v] = u;
-                        pq.push({Dist[v], v});
-                    }
-                }
-            }
-        }
-        for (int v = 0; v < num_vertices; ++v) {
-            if (Parent[v] != -1) Tree.insert({Parent[v], v});
-        }
+        LoadedGraph whole;
+        if (size > 1 && !load_graph(graphFile, TextFormat::Metis, whole)) MPI_Abort(MPI_COMM_WORLD, 1);
+        auto start_seq = std::chrono::high_resolution_clock::now();
+        dijkstra(size > 1 ? whole.graph : graph, 0, queue_kind, Dist, Parent);
+        auto end_seq = std::chrono::high_resolution_clock::now();
+        seq_time = std::chrono::duration<double>(end_seq - start_seq).count();
         // Log initial distances
         for (int i = 0; i < std::min(10, num_vertices); ++i) {
             std::cout << "Sequential Initial Dist[" << i << "]: " << (Dist[i] == INF ? -1 : Dist[i]) << "\n";
         }
     }
-    auto end_seq = std::chrono::high_resolution_clock::now();
-    double seq_time = std::chrono::duration<double>(end_seq - start_seq).count();
-
-    // Broadcast sequential results
-    MPI_Bcast(Dist.data(), num_vertices, MPI_LONG_LONG, 0, MPI_COMM_WORLD);
-    MPI_Bcast(Parent.data(), num_vertices, MPI_INT, 0, MPI_COMM_WORLD);
 
+    // Parallel SSSP from scratch. "distributed" (default) runs bucket-synchronous
+    // delta-stepping that only ships cross-partition relaxations to their owners, or a
+    // direction-optimizing BFS when every edge weighs 1; "bsp" runs delta-stepping over
+    // each rank's own rows and merges full label arrays per round.
     auto start_mpi = std::chrono::high_resolution_clock::now();
-    std::priority_queue<std::pair<long long, int>, std::vector<std::pair<long long, int>>, std::greater<>> pq;
-    std::set<int> in_pq;
-
-    for (int v : graph.localVertices) {
-        if (Dist[v] != INF) {
-            pq.push({Dist[v], v});
-            in_pq.insert(v);
+    std::string sssp_mode = cli.get("sssp", "distributed");
+    int unit_weights = graph.unitWeights();
+    MPI_Allreduce(MPI_IN_PLACE, &unit_weights, 1, MPI_INT, MPI_LAND, MPI_COMM_WORLD);
+    if (sssp_mode == "distributed" && unit_weights) {
+        DistributedBFS bfs(graph, MPI_COMM_WORLD);
+        bfs.run(0, Dist, Parent);
+        long long messages = bfs.messages();
+        MPI_Reduce(rank == 0 ? MPI_IN_PLACE : &messages, &messages, 1, MPI_LONG_LONG, MPI_SUM, 0, MPI_COMM_WORLD);
+        if (rank == 0) {
+            std::cout << "Rank " << rank << ": Distributed BFS with " << bfs.levels() << " levels ("
+                      << bfs.bottomUpLevels() << " bottom-up), " << messages << " messages\n";
         }
-    }
-
-    int global_changed = 1;
-    while (global_changed) {
-        bool local_changed = false;
-        while (!pq.empty()) {
-            int u = pq.top().second;
-            pq.pop();
-            in_pq.erase(u);
-
-            if (std::find(graph.localVertices.begin(), graph.localVertices.end(), u) != graph.localVertices.end()) {
-                auto it = graph.adjacencyList.find(u);
-                if (it != graph.adjacencyList.end()) {
-                    std::vector<std::pair<long long, int>> local_pq_entries[4];
-                    #pragma omp parallel
-                    {
-                        int tid = omp_get_thread_num();
-                        #pragma omp for
-                        for (size_t i = 0; i < it->second.size(); ++i) {
-                            int v = it->second[i].dest;
-                            if (v >= 0 && v < num_vertices) {
-                                long long w = it->second[i].weight;
-                                long long new_dist = Dist[u] + w;
-                                if (new_dist < Dist[v]) {
-                                    #pragma omp critical
-                                    {
-                                        Dist[v] = new_dist;
-                                        Parent[v] = u;
-                                        Affected[v] = 1;
-                                        local_changed = true;
-                                    }
-                                    local_pq_entries[tid].push_back({new_dist, v});
-                                }
-                            }
-                        }
-                    }
-                    for (int tid = 0; tid < 4; ++tid) {
-                        for (const auto& entry : local_pq_entries[tid]) {
-                            long long new_dist = entry.first;
-                            int v = entry.second;
-                            if (!in_pq.count(v)) {
-                                pq.push({new_dist, v});
-                                in_pq.insert(v);
-                            }
-                        }
-                    }
-                }
-            }
+    } else if (sssp_mode == "distributed") {
+        DistributedDeltaStepping engine(graph, MPI_COMM_WORLD, cli.getInt("delta", 0));
+        engine.run(0, Dist, Parent);
+        long long messages = engine.messages();
+        MPI_Reduce(rank == 0 ? MPI_IN_PLACE : &messages, &messages, 1, MPI_LONG_LONG, MPI_SUM, 0, MPI_COMM_WORLD);
+        if (rank == 0) {
+            std::cout << "Rank " << rank << ": Distributed delta-stepping with delta = " << engine.delta() << ", "
+                      << engine.phases() << " phases, " << messages << " relaxation messages\n";
         }
+    } else if (sssp_mode == "bsp") {
+        DeltaStepping engine(graph, cli.getInt("delta", 0));
+        if (rank == 0) std::cout << "Rank " << rank << ": Delta-stepping with delta = " << engine.delta() << "\n";
+        std::fill(Dist.begin(), Dist.end(), INF);
+        std::fill(Parent.begin(), Parent.end(), -1);
+        Dist[0] = 0;
+        std::vector<int> seeds(1, 0);
+        std::vector<PackedLabel> labels(num_vertices);
+        int rounds = 0;
+        int global_changed = 1;
+        while (global_changed) {
+            engine.run(seeds, Dist, Parent);
+            ++rounds;
 
-        int local_changed_int = local_changed ? 1 : 0;
-        int global_changed_int = 0;
-        MPI_Allreduce(&local_changed_int, &global_changed_int, 1, MPI_INT, MPI_LOR, MPI_COMM_WORLD);
-        global_changed = global_changed_int;
-
-        MPI_Allreduce(MPI_IN_PLACE, Dist.data(), Dist.size(), MPI_LONG_LONG, MPI_MIN, MPI_COMM_WORLD);
-        MPI_Allreduce(MPI_IN_PLACE, Parent.data(), Parent.size(), MPI_INT, MPI_MAX, MPI_COMM_WORLD);
-        MPI_Allreduce(MPI_IN_PLACE, Affected.data(), Affected.size(), MPI_INT, MPI_MAX, MPI_COMM_WORLD);
-    }
-
-    for (int v = 0; v < num_vertices; ++v) {
-        if (Parent[v] != -1) Tree.insert({Parent[v], v});
-    }
+            // Distance and parent merge in one reduction over packed labels: the minimum
+            // is the shortest distance and, on a tie, the smallest parent id (none sorts
+            // last), so every rank adopts the same parent as the distance it came with
+            #pragma omp parallel for schedule(static)
+            for (int v = 0; v < num_vertices; ++v) labels[v] = pack_label(Dist[v], Parent[v]);
+            MPI_Allreduce(MPI_IN_PLACE, labels.data(), num_vertices, MPI_UINT64_T, MPI_MIN, MPI_COMM_WORLD);
+            seeds.clear();
+            for (int v = 0; v < num_vertices; ++v) {
+                long long d = label_dist(labels[v]);
+                if (d < Dist[v] && graph.row(v) >= 0) seeds.push_back(v);
+                Dist[v] = d;
+                Parent[v] = label_parent(labels[v]);
+            }
 
-    std::vector<int> tree_data;
-    if (rank == 0) {
-        for (const auto& [u, v] : Tree) {
-            tree_data.push_back(u);
-            tree_data.push_back(v);
+            int local_changed_int = seeds.empty() ? 0 : 1;
+            MPI_Allreduce(&local_changed_int, &global_changed, 1, MPI_INT, MPI_LOR, MPI_COMM_WORLD);
         }
+        if (rank == 0) std::cout << "Rank " << rank << ": Delta-stepping converged in " << rounds << " rounds\n";
+    } else {
+        if (rank == 0) std::cerr << "Unknown --sssp mode " << sssp_mode << "\n";
+        MPI_Abort(MPI_COMM_WORLD, 1);
     }
-    int tree_size = tree_data.size();
-    MPI_Bcast(&tree_size, 1, MPI_INT, 0, MPI_COMM_WORLD);
-    tree_data.resize(tree_size);
-    MPI_Bcast(tree_data.data(), tree_size, MPI_INT, 0, MPI_COMM_WORLD);
-    if (rank != 0) {
-        Tree.clear();
-        for (int i = 0; i < tree_size; i += 2) {
-            Tree.insert({tree_data[i], tree_data[i + 1]});
-        }
+
+    // From here on each rank keeps only its own vertices and their ghosts, numbered by the
+    // vertex map (owned first); the full-length arrays of the initial SSSP are dropped
+    VertexMap map(graph, MPI_COMM_WORLD);
+    GhostExchange ghosts(graph, map, MPI_COMM_WORLD);
+    {
+        std::vector<long long> full_dist;
+        std::vector<int> full_parent;
+        full_dist.swap(Dist);
+        full_parent.swap(Parent);
+        localize_labels(map, ghosts, full_dist, full_parent, Dist, Parent);
     }
+    std::vector<int> AffectedDel(map.size(), 0);
+    std::vector<int> Affected(map.size(), 0);
+    DistributedTree Tree(map.numOwned(), Parent);
     auto end_mpi = std::chrono::high_resolution_clock::now();
     double mpi_time = std::chrono::duration<double>(end_mpi - start_mpi).count();
 
-    // Multiple dynamic updates
+    // Dynamic updates: rank 0 reads batches of --batch records from --updates FILE and
+    // broadcasts them, otherwise --rounds generated batches (default 20 batches of 2 updates
+    // drawn from --mix, default 1:1 insert:delete; see workload.h), each rank drawing its
+    // share from its own vertices
+    std::string updatesFile = cli.get("updates", "");
+    UpdateStream stream;
+    if (rank == 0 && !updatesFile.empty() && !stream.open(updatesFile, num_vertices)) MPI_Abort(MPI_COMM_WORLD, 1);
+    WorkloadSpec workload;
+    if (!parse_workload_spec(cli, workload)) MPI_Abort(MPI_COMM_WORLD, 1);
+    WorkloadGenerator generator(graph, workload, rank);
+    int rounds = cli.getInt("rounds", 20);
+    long long batch_size = std::max(1LL, cli.getInt("batch", updatesFile.empty() ? 2 : 1000));
+    std::vector<EdgeUpdate> batch, local;
+    long long applied = 0;
+    // --overlap relaxes interior vertices while boundary labels are in flight, --async
+    // drops the rounds altogether
+    UpdateSchedule schedule = cli.has("async")     ? UpdateSchedule::Async
+                              : cli.has("overlap") ? UpdateSchedule::Overlap
+                                                   : UpdateSchedule::Rounds;
+
+    // Every rank publishes its local arrays (owned vertices, then ghosts) after each batch;
+    // queries read the last published epoch. --readers N runs N query threads per rank during the updates.
+    VersionedDistances store;
+    store.reset(Dist, Parent);
+    std::unique_ptr<SnapshotReaders> readers;
+    if (cli.getInt("readers", 0) > 0) {
+        readers = std::make_unique<SnapshotReaders>(store, cli.getInt("readers", 0), workload.seed + rank);
+    }
+
     auto start_update = std::chrono::high_resolution_clock::now();
-    const int num_updates = 20;
-    for (int update = 0; update < num_updates; ++update) {
+    for (int update = 0;; ++update) {
         std::vector<std::pair<int, int>> Delk;
         std::vector<std::tuple<int, int, int>> Insk;
-        if (rank == 0) {
-            // Select tree edge for deletion
-            if (!Tree.empty()) {
-                auto it = Tree.begin();
-                std::advance(it, update % Tree.size());
-                Delk.push_back(*it);
-            }
-            // Select non-existent edge for insertion
-            for (int i = 0; i < num_vertices; ++i) {
-                for (int j = i + 1; j < num_vertices; ++j) {
-                    bool connected = false;
-                    auto it = graph.adjacencyList.find(i);
-                    if (it != graph.adjacencyList.end()) {
-                        for (const auto& edge : it->second) {
-                            if (edge.dest == j) {
-                                connected = true;
-                                break;
-                            }
-                        }
-                    }
-                    if (!connected) {
-                        Insk.emplace_back(i, j, 1);
-                        break;
-                    }
-                }
-                if (!Insk.empty()) break;
+        if (!updatesFile.empty()) {
+            int more = 0;
+            if (rank == 0) {
+                more = stream.next(batch_size, batch);
+                if (stream.failed()) MPI_Abort(MPI_COMM_WORLD, 1);
             }
+            MPI_Bcast(&more, 1, MPI_INT, 0, MPI_COMM_WORLD);
+            if (!more) break;
+            broadcast_updates(batch, 0, MPI_COMM_WORLD);
+            applied += batch.size();
+        } else {
+            if (update == rounds) break;
+            local.clear();
+            auto parent = [&](int v) {
+                int l = map.local(v);
+                return l < 0 || Parent[l] < 0 ? -1 : map.global(Parent[l]);
+            };
+            generator.generate(batch_size / size + (rank < batch_size % size), parent, local);
+            batch = allgather_updates(local, MPI_COMM_WORLD);
         }
+        split_updates(batch, Delk, Insk);
 
-        // Broadcast Delk and Insk
-        int delk_size = Delk.size();
-        MPI_Bcast(&delk_size, 1, MPI_INT, 0, MPI_COMM_WORLD);
-        Delk.resize(delk_size);
+        ProcessCE(graph, Delk, Insk, Dist, Parent, AffectedDel, Affected, Gu, Tree, map, ghosts, rank, size);
+        UpdateAffectedVertices(graph, Gu, Tree, Dist, Parent, AffectedDel, Affected, map, ghosts, rank, size, schedule);
+        size_t pages = store.commit(Dist, Parent);
         if (rank == 0) {
-            for (size_t i = 0; i < Delk.size(); ++i) {
-                tree_data[i * 2] = Delk[i].first;
-                tree_data[i * 2 + 1] = Delk[i].second;
-            }
+            std::cout << "Rank " << rank << ": Committed epoch " << store.snapshot()->epoch() << ", " << pages
+                      << " pages copied\n";
         }
-        tree_data.resize(delk_size * 2);
-        MPI_Bcast(tree_data.data(), delk_size * 2, MPI_INT, 0, MPI_COMM_WORLD);
-        if (rank != 0) {
-            Delk.clear();
-            for (int i = 0; i < delk_size; ++i) {
-                Delk.emplace_back(tree_data[i * 2], tree_data[i * 2 + 1]);
-            }
-        }
-
-        int insk_size = Insk.size();
-        MPI_Bcast(&insk_size, 1, MPI_INT, 0, MPI_COMM_WORLD);
-        Insk.resize(insk_size);
-        std::vector<int> insk_data(insk_size * 3);
-        if (rank == 0) {
-            for (size_t i = 0; i < Insk.size(); ++i) {
-                insk_data[i * 3] = std::get<0>(Insk[i]);
-                insk_data[i * 3 + 1] = std::get<1>(Insk[i]);
-                insk_data[i * 3 + 2] = std::get<2>(Insk[i]);
-            }
-        }
-        MPI_Bcast(insk_data.data(), insk_size * 3, MPI_INT, 0, MPI_COMM_WORLD);
-        if (rank != 0) {
-            Insk.clear();
-            for (int i = 0; i < insk_size; ++i) {
-                Insk.emplace_back(insk_data[i * 3], insk_data[i * 3 + 1], insk_data[i * 3 + 2]);
-            }
-        }
-
-        ProcessCE(graph, Delk, Insk, Dist, Parent, AffectedDel, Affected, Gu, Tree, rank, size);
-        UpdateAffectedVertices(graph, Gu, Tree, Dist, Parent, AffectedDel, Affected, rank, size);
+    }
+    if (readers) {
+        ReadStats stats = readers->stop();
+        std::cout << "Rank " << rank << ": Served " << stats.queries << " queries during updates, mean "
+                  << stats.mean_us << " us, max " << stats.max_us << " us, across " << stats.epochs << " epochs\n";
     }
 
     auto end_update = std::chrono::high_resolution_clock::now();
     double update_time = std::chrono::duration<double>(end_update - start_update).count();
+    long long labels_sent = ghosts.messages();
+    MPI_Reduce(rank == 0 ? MPI_IN_PLACE : &labels_sent, &labels_sent, 1, MPI_LONG_LONG, MPI_SUM, 0, MPI_COMM_WORLD);
+    std::vector<long long> final_dist = gather_owned(map, Dist, INF, 0, MPI_COMM_WORLD);
 
     MPI_Barrier(MPI_COMM_WORLD);
     if (rank == 0) {
         std::cout << "Sequential Dijkstra Time: " << seq_time << " seconds\n";
-        std::cout << "MPI+OpenMP Dijkstra Time: " << mpi_time << " seconds\n";
-        std::cout << "Speedup (Dijkstra): " << seq_time / mpi_time << "x\n";
+        std::cout << "MPI+OpenMP Delta-Stepping Time: " << mpi_time << " seconds\n";
+        std::cout << "Speedup (initial SSSP): " << seq_time / mpi_time << "x\n";
         std::cout << "Update Phase Time: " << update_time << " seconds\n";
+        std::cout << "Labels exchanged with ghost holders: " << labels_sent << "\n";
+        if (!updatesFile.empty()) std::cout << "Applied " << applied << " updates from " << updatesFile << "\n";
+        // The first six unless --print-all
         std::cout << "Final Distances:\n";
-        for (int i = 0; i < std::min(6, num_vertices); ++i) {
-            std::cout << "Node " << i << ": " << (Dist[i] == INF ? -1 : Dist[i]) << "\n";
+        int shown = cli.has("print-all") ? num_vertices : std::min(6, num_vertices);
+        for (int i = 0; i < shown; ++i) {
+            std::cout << "Node " << i << ": " << (final_dist[i] == INF ? -1 : final_dist[i]) << "\n";
         }
     }
     MPI_Barrier(MPI_COMM_WORLD);
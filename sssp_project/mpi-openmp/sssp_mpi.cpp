@@ -1,10 +1,78 @@
 #include "sssp_mpi.h"
+#include "atomic_label.h"
+#include "dist_loader.h"
 #include <omp.h>
 #include <algorithm>
 #include <queue>
 #include <limits>
 #include <mpi.h>
 #include <iostream>
+#include <sstream>
+
+namespace {
+
+// One write per line, so lines from different threads do not interleave
+template <class... Args>
+void log_line(Args&&... args) {
+    std::ostringstream line;
+    (line << ... << args);
+    std::cout << line.str();
+}
+
+// Vertices changed by a parallel loop, one list per thread
+using ChangeLists = std::vector<std::vector<int>>;
+
+// Relinks the tree and posts every changed vertex once; owned ones are queued in next
+void post_changes(ChangeLists& changed, const LabelArray& labels, DistributedTree& Tree, GhostExchange& ghosts,
+                  Frontier& seen, Frontier& next) {
+    seen.clear();
+    for (auto& list : changed) {
+        for (int x : list) {
+            if (!seen.insert(x)) continue;
+            Tree.setParent(x, labels.parent(x));
+            ghosts.post(x, labels.dist(x), labels.parent(x));
+            if (ghosts.owns(x)) next.insert(x);
+        }
+        list.clear();
+    }
+}
+
+// A ghost takes the label its owner sent. An owned vertex takes a shorter proposal, or an
+// invalidation naming its current parent; an accepted change is queued in next and passed
+// on to the ghost holders, a refused one answers with the owner's label so the sender's
+// copy is corrected.
+void apply_labels(const std::vector<LabelMessage>& received, LabelArray& labels, DistributedTree& Tree,
+                  GhostExchange& ghosts, Frontier& next) {
+    for (const LabelMessage& m : received) {
+        int v = m.v;
+        if (!ghosts.owns(v)) {
+            labels.assign(v, m.dist, m.parent);
+            Tree.setParent(v, m.parent);
+            continue;
+        }
+        bool accepted = m.dist == DIST_INF ? labels.parent(v) == m.parent && labels.invalidate(v)
+                                           : labels.relax(v, m.dist, m.parent);
+        if (accepted) {
+            Tree.setParent(v, m.parent);
+            next.insert(v);
+        } else if (labels.dist(v) == m.dist && labels.parent(v) == m.parent) {
+            continue;
+        }
+        ghosts.post(v, labels.dist(v), labels.parent(v));
+    }
+}
+
+// Collective. Rounds continue while any rank has a frontier or labels to send
+long long global_pending(const Frontier& frontier, const GhostExchange& ghosts) {
+    long long pending = frontier.size() + ghosts.queued();
+    MPI_Allreduce(MPI_IN_PLACE, &pending, 1, MPI_LONG_LONG, MPI_SUM, MPI_COMM_WORLD);
+    return pending;
+}
+
+} // namespace
+
+// All vertex ids below are local ids of the VertexMap; updates arrive with global ids
+// and are translated, and log lines print global ids.
 
 void ProcessCE(
     Graph& graph,
@@ -15,184 +83,271 @@ void ProcessCE(
     std::vector<int>& AffectedDel,
     std::vector<int>& Affected,
     std::vector<std::tuple<int, int, int>>& Gu,
-    std::set<std::pair<int, int>>& Tree,
+    DistributedTree& Tree,
+    VertexMap& map,
+    GhostExchange& ghosts,
     int rank,
     int size
 ) {
     const long long INF = std::numeric_limits<long long>::max();
-    std::fill(AffectedDel.begin(), AffectedDel.end(), 0);
-    std::fill(Affected.begin(), Affected.end(), 0);
+    auto in_range = [&](int v) { return v >= 0 && v < map.numVertices(); };
+    auto owned = [&](int l) { return l >= 0 && map.owned(l); };
+
+    // Endpoints of edges inserted into this rank's rows become ghosts first, and both sides
+    // of a new cut edge send the label of their own endpoint across
+    std::vector<int> wanted;
+    for (const auto& [u, v, w] : Insk) {
+        if (!in_range(u) || !in_range(v)) continue;
+        if (owned(map.local(u))) wanted.push_back(v);
+        if (owned(map.local(v))) wanted.push_back(u);
+    }
+    map.addGhosts(wanted);
+    int n = map.size();
+    Dist.resize(n, INF);
+    Parent.resize(n, -1);
+    AffectedDel.assign(n, 0);
+    Affected.assign(n, 0);
+    Tree.resize(n);
+
+    std::vector<std::pair<int, int>> introductions;
+    for (const auto& [u, v, w] : Insk) {
+        int lu = in_range(u) ? map.local(u) : -1, lv = in_range(v) ? map.local(v) : -1;
+        if (lu < 0 || lv < 0) continue;
+        if (map.owned(lu)) {
+            int o = ghosts.addEdge(lu, lv);
+            if (o >= 0) introductions.push_back({o, lu});
+        }
+        if (map.owned(lv)) {
+            int o = ghosts.addEdge(lv, lu);
+            if (o >= 0) introductions.push_back({o, lv});
+        }
+    }
+    ghosts.refresh();
+    std::vector<LabelMessage> received;
+    for (const auto& [o, l] : introductions) ghosts.postTo(o, l, Dist[l], Parent[l]);
+    ghosts.exchange(received);
+    for (const LabelMessage& m : received) {
+        Dist[m.v] = m.dist;
+        Parent[m.v] = m.parent;
+        Tree.setParent(m.v, m.parent);
+    }
+
+    // Threads lower packed labels with CAS and raise flags atomically, no locks
+    LabelArray labels;
+    labels.load(Dist, Parent);
+    ChangeLists changed(omp_get_max_threads());
+    // Only ranks holding a row of one endpoint act on the change; both endpoints are local there
+    auto acting = [&](int u, int v, int& lu, int& lv) {
+        lu = in_range(u) ? map.local(u) : -1;
+        lv = in_range(v) ? map.local(v) : -1;
+        return lu >= 0 && lv >= 0 && (map.owned(lu) || map.owned(lv));
+    };
 
     #pragma omp parallel for
     for (size_t i = 0; i < Delk.size(); ++i) {
-        int u = Delk[i].first;
-        int v = Delk[i].second;
-        if (u >= 0 && u < Dist.size() && v >= 0 && v < Dist.size()) {
-            if (std::find(graph.localVertices.begin(), graph.localVertices.end(), u) != graph.localVertices.end() ||
-                std::find(graph.localVertices.begin(), graph.localVertices.end(), v) != graph.localVertices.end()) {
-                if (Tree.count({u, v}) || Tree.count({v, u})) {
-                    int y = Dist[u] > Dist[v] ? u : v;
-                    #pragma omp critical
-                    {
-                        if (y >= 0 && y < Dist.size()) {
-                            std::cout << "Rank " << rank << ": ProcessCE Delk set Dist[" << y << "] to INF\n";
-                            Dist[y] = INF;
-                            AffectedDel[y] = 1;
-                            Affected[y] = 1;
-                        }
-                    }
-                }
+        int u, v;
+        if (acting(Delk[i].first, Delk[i].second, u, v) && Tree.isTreeEdge(u, v)) {
+            int y = Tree.parent(v) == u ? v : u;
+            if (labels.invalidate(y)) {
+                log_line("Rank ", rank, ": ProcessCE Delk set Dist[", map.global(y), "] to INF\n");
+                changed[omp_get_thread_num()].push_back(y);
             }
+            atomic_set_flag(AffectedDel[y]);
+            atomic_set_flag(Affected[y]);
         }
     }
 
     #pragma omp parallel for
     for (size_t i = 0; i < Insk.size(); ++i) {
-        int u = std::get<0>(Insk[i]);
-        int v = std::get<1>(Insk[i]);
+        int u, v;
         int w = std::get<2>(Insk[i]);
-        if (u >= 0 && u < Dist.size() && v >= 0 && v < Dist.size()) {
-            if (std::find(graph.localVertices.begin(), graph.localVertices.end(), u) != graph.localVertices.end() ||
-                std::find(graph.localVertices.begin(), graph.localVertices.end(), v) != graph.localVertices.end()) {
-                int x = Dist[u] > Dist[v] ? v : u;
-                int y = (x == u) ? v : u;
-                #pragma omp critical
-                {
-                    if (x >= 0 && x < Dist.size() && y >= 0 && y < Dist.size() && Dist[x] != INF) {
-                        if (Dist[y] > Dist[x] + w) {
-                            std::cout << "Rank " << rank << ": ProcessCE Insk updated Dist[" << y << "] to " << Dist[x] + w << "\n";
-                            Dist[y] = Dist[x] + w;
-                            Parent[y] = x;
-                            Affected[y] = 1;
-                        }
-                        Gu.push_back({u, v, w});
-                    }
-                }
-            }
+        if (!acting(std::get<0>(Insk[i]), std::get<1>(Insk[i]), u, v)) continue;
+        int x = labels.dist(u) > labels.dist(v) ? v : u;
+        int y = (x == u) ? v : u;
+        long long dx = labels.dist(x);
+        if (dx != INF && labels.relax(y, dx + w, x)) {
+            log_line("Rank ", rank, ": ProcessCE Insk updated Dist[", map.global(y), "] to ", dx + w, "\n");
+            changed[omp_get_thread_num()].push_back(y);
+            atomic_set_flag(Affected[y]);
         }
     }
 
-    // Update adjacency list
+    // Update adjacency list in the rows of the owned endpoints
+    for (const auto& [u, v] : Delk) {
+        int lu = in_range(u) ? map.local(u) : -1, lv = in_range(v) ? map.local(v) : -1;
+        if (owned(lu)) graph.eraseEdge(map.row(lu), v);
+        if (owned(lv)) graph.eraseEdge(map.row(lv), u);
+    }
     for (const auto& [u, v, w] : Insk) {
-        if (std::find(graph.localVertices.begin(), graph.localVertices.end(), u) != graph.localVertices.end()) {
-            graph.adjacencyList[u].push_back({v, w});
-        }
-        if (std::find(graph.localVertices.begin(), graph.localVertices.end(), v) != graph.localVertices.end()) {
-            graph.adjacencyList[v].push_back({u, w});
-        }
+        int lu, lv;
+        if (!acting(u, v, lu, lv)) continue;
+        if (map.owned(lu)) graph.insertEdge(map.row(lu), v, w);
+        if (map.owned(lv)) graph.insertEdge(map.row(lv), u, w);
+        Gu.push_back({u, v, w});
     }
 
-    MPI_Allreduce(MPI_IN_PLACE, Dist.data(), Dist.size(), MPI_LONG_LONG, MPI_MIN, MPI_COMM_WORLD);
-    MPI_Allreduce(MPI_IN_PLACE, Parent.data(), Parent.size(), MPI_INT, MPI_MAX, MPI_COMM_WORLD);
-    MPI_Allreduce(MPI_IN_PLACE, Affected.data(), Affected.size(), MPI_INT, MPI_MAX, MPI_COMM_WORLD);
+    // Only the changed labels move, and only between the owner and the ghost holders.
+    // Both ranks of a cut edge act on its update, and the owner settles the label.
+    Frontier seen(n), touched(n);
+    post_changes(changed, labels, Tree, ghosts, seen, touched);
+    ghosts.exchange(received);
+    apply_labels(received, labels, Tree, ghosts, touched);
+    touched.forEach([&](int v) {
+        Affected[v] = 1;
+        if (labels.dist(v) == INF) AffectedDel[v] = 1;
+    });
+    labels.store(Dist, Parent);
 }
 
 void UpdateAffectedVertices(
     Graph& graph,
     std::vector<std::tuple<int, int, int>>& Gu,
-    std::set<std::pair<int, int>>& Tree,
+    DistributedTree& Tree,
     std::vector<long long>& Dist,
     std::vector<int>& Parent,
     std::vector<int>& AffectedDel,
     std::vector<int>& Affected,
+    const VertexMap& map,
+    GhostExchange& ghosts,
     int rank,
-    int size
+    int size,
+    UpdateSchedule schedule
 ) {
     const long long INF = std::numeric_limits<long long>::max();
-    std::vector<std::vector<int>> children(Dist.size());
-    std::vector<int> visited(Dist.size(), 0); // Track visited vertices in deletion phase
-    const int max_iterations = Dist.size(); // Limit iterations to vertex count
-
-    // Build children array
-    for (int v = 0; v < Dist.size(); ++v) {
-        if (Parent[v] != -1 && Parent[v] >= 0 && Parent[v] < Dist.size()) {
-            children[Parent[v]].push_back(v);
-        }
-    }
 
-    // Deletion phase
-    int global_del_changed = 1;
+    LabelArray labels;
+    labels.load(Dist, Parent);
+    ChangeLists changed(omp_get_max_threads());
+    std::vector<LabelMessage> received;
+    std::vector<int> work;
+
+    // Deletion phase; each round walks only the owned vertices invalidated by the previous
+    // one, here or by a ghost holder of theirs. affected collects them for the update phase.
+    Frontier frontier(Dist.size()), next(Dist.size()), affected(Dist.size()), seen(Dist.size());
+    take_owned_flags(map.numOwned(), Affected, affected, MPI_COMM_WORLD);
+    take_owned_flags(map.numOwned(), AffectedDel, frontier, MPI_COMM_WORLD);
     int iteration = 0;
-    while (global_del_changed && iteration < max_iterations) {
-        bool local_del_changed = false;
+    // A child has one parent, so every label below has a single writer. Only a child
+    // whose distance was still finite is walked next, which ends the walk at a cycle an
+    // insertion closed by re-attaching a vertex below its own subtree.
+    auto invalidate_children = [&]() {
         #pragma omp parallel for
-        for (int v : graph.localVertices) {
-            if (v >= 0 && v < Dist.size() && AffectedDel[v] && !visited[v]) {
-                #pragma omp critical
-                {
-                    AffectedDel[v] = 0;
-                    visited[v] = 1; // Mark as processed
-                    for (int c : children[v]) {
-                        if (c >= 0 && c < Dist.size() && !visited[c]) {
-                            std::cout << "Rank " << rank << ": UpdateAffectedVertices Del set Dist[" << c << "] to INF (iteration " << iteration << ")\n";
-                            Dist[c] = INF;
-                            AffectedDel[c] = 1;
-                            Affected[c] = 1;
-                            local_del_changed = true;
-                        }
-                    }
-                }
-            }
+        for (size_t i = 0; i < work.size(); ++i) {
+            Tree.forEachChild(work[i], [&](int c) {
+                if (!labels.invalidate(c)) return;
+                log_line("Rank ", rank, ": UpdateAffectedVertices Del set Dist[", map.global(c), "] to INF (iteration ", iteration, ")\n");
+                changed[omp_get_thread_num()].push_back(c);
+            });
         }
+    };
 
-        int local_del_changed_int = local_del_changed ? 1 : 0;
-        int global_del_changed_int = 0;
-        MPI_Allreduce(&local_del_changed_int, &global_del_changed_int, 1, MPI_INT, MPI_LOR, MPI_COMM_WORLD);
-        global_del_changed = global_del_changed_int;
+    // Asynchronous mode: a rank works whatever it has and sends the changed labels at
+    // once, then takes whatever has arrived; nobody waits for a round to end, and the
+    // phase ends when the ghost exchange detects global quiescence
+    auto run_async = [&](auto&& step, auto&& accepted) {
+        do {
+            frontier.toVector(work);
+            step();
+            next.clear();
+            post_changes(changed, labels, Tree, ghosts, seen, next);
+            ghosts.flush();
+            ghosts.poll(received);
+            apply_labels(received, labels, Tree, ghosts, next);
+            accepted();
+            frontier.swap(next);
+            iteration++;
+        } while (!ghosts.quiescent(frontier.size() == 0 && ghosts.queued() == 0));
+    };
 
-        MPI_Allreduce(MPI_IN_PLACE, Dist.data(), Dist.size(), MPI_LONG_LONG, MPI_MIN, MPI_COMM_WORLD);
-        MPI_Allreduce(MPI_IN_PLACE, AffectedDel.data(), AffectedDel.size(), MPI_INT, MPI_MAX, MPI_COMM_WORLD);
-        MPI_Allreduce(MPI_IN_PLACE, Affected.data(), Affected.size(), MPI_INT, MPI_MAX, MPI_COMM_WORLD);
-        iteration++;
-    }
+    // Both phases run until nothing is left anywhere; a label is invalidated at most once
+    // per walk and otherwise only falls, so neither needs an iteration cap
+    if (schedule == UpdateSchedule::Async) {
+        run_async(invalidate_children, [&]() { next.forEach([&](int v) { affected.insert(v); }); });
+    } else {
+        while (global_pending(frontier, ghosts) > 0) {
+            frontier.toVector(work);
+            invalidate_children();
 
-    if (iteration >= max_iterations) {
-        std::cout << "Rank " << rank << ": Warning: Deletion phase reached max iterations (" << max_iterations << "), possible cycle in Parent\n";
+            next.clear();
+            post_changes(changed, labels, Tree, ghosts, seen, next);
+            ghosts.exchange(received);
+            apply_labels(received, labels, Tree, ghosts, next);
+            next.forEach([&](int v) { affected.insert(v); });
+            frontier.swap(next);
+            iteration++;
+        }
     }
 
     // Update phase
-    int global_changed = 1;
-    while (global_changed) {
-        bool local_changed = false;
-        #pragma omp parallel for
-        for (int v : graph.localVertices) {
-            if (v >= 0 && v < Dist.size() && Affected[v]) {
-                Affected[v] = 0;
-                auto it = graph.adjacencyList.find(v);
-                if (it != graph.adjacencyList.end()) {
-                    for (const auto& edge : it->second) {
-                        int n = edge.dest;
-                        long long w = edge.weight;
-                        if (n >= 0 && n < Dist.size()) {
-                            #pragma omp critical
-                            {
-                                if (Dist[v] != INF && Dist[n] > Dist[v] + w) {
-                                    std::cout << "Rank " << rank << ": UpdateAffectedVertices set Dist[" << n << "] to " << Dist[v] + w << "\n";
-                                    Dist[n] = Dist[v] + w;
-                                    Parent[n] = v;
-                                    Affected[n] = 1;
-                                    local_changed = true;
-                                } else if (Dist[n] != INF && Dist[v] > Dist[n] + w) {
-                                    std::cout << "Rank " << rank << ": UpdateAffectedVertices set Dist[" << v << "] to " << Dist[n] + w << "\n";
-                                    Dist[v] = Dist[n] + w;
-                                    Parent[v] = n;
-                                    Affected[v] = 1;
-                                    local_changed = true;
-                                }
-                            }
-                        }
-                    }
-                }
+    auto relax = [&](int v, std::vector<int>& mine) {
+        graph.forEachEdge(map.row(v), [&](int global_n, long long w) {
+            int n = map.local(global_n);
+            if (n < 0) return;
+            long long dv = labels.dist(v), dn = labels.dist(n);
+            if (dv != INF && labels.relax(n, dv + w, v)) {
+                log_line("Rank ", rank, ": UpdateAffectedVertices set Dist[", global_n, "] to ", dv + w, "\n");
+                mine.push_back(n);
+            } else if (dn != INF && labels.relax(v, dn + w, n)) {
+                log_line("Rank ", rank, ": UpdateAffectedVertices set Dist[", map.global(v), "] to ", dn + w, "\n");
+                mine.push_back(v);
             }
+        });
+    };
+    auto relax_range = [&](size_t begin, size_t end) {
+        #pragma omp parallel for schedule(dynamic, 64)
+        for (size_t i = begin; i < end; ++i) relax(work[i], changed[omp_get_thread_num()]);
+    };
+
+    frontier.swap(affected);
+    if (schedule == UpdateSchedule::Async) {
+        run_async([&]() { relax_range(0, work.size()); }, []() {});
+        labels.store(Dist, Parent);
+        return;
+    }
+    if (schedule == UpdateSchedule::Rounds) {
+        while (global_pending(frontier, ghosts) > 0) {
+            frontier.toVector(work);
+            relax_range(0, work.size());
+            next.clear();
+            post_changes(changed, labels, Tree, ghosts, seen, next);
+            ghosts.exchange(received);
+            apply_labels(received, labels, Tree, ghosts, next);
+            frontier.swap(next);
         }
+        labels.store(Dist, Parent);
+        return;
+    }
 
-        int local_del_changed_int = local_changed ? 1 : 0;
-        int global_changed_int = 0;
-        MPI_Allreduce(&local_del_changed_int, &global_changed_int, 1, MPI_INT, MPI_LOR, MPI_COMM_WORLD);
-        global_changed = global_changed_int;
+    // Overlapped rounds: the boundary vertices of the frontier are relaxed first and their
+    // changes sent, then the interior ones, which touch no label another rank holds, are
+    // relaxed in chunks while the labels are in flight. Interior changes to boundary
+    // vertices go out with the next round. The pending count is reduced alongside the
+    // round; a round that started with nothing pending anywhere changed nothing, so the
+    // loop ends after it.
+    const size_t chunk = 1024;
+    long long pending = 1;
+    while (pending > 0) {
+        long long local_pending = frontier.size() + ghosts.queued();
+        MPI_Request pending_req;
+        MPI_Iallreduce(&local_pending, &pending, 1, MPI_LONG_LONG, MPI_SUM, MPI_COMM_WORLD, &pending_req);
 
-        MPI_Allreduce(MPI_IN_PLACE, Dist.data(), Dist.size(), MPI_LONG_LONG, MPI_MIN, MPI_COMM_WORLD);
-        MPI_Allreduce(MPI_IN_PLACE, Parent.data(), Parent.size(), MPI_INT, MPI_MAX, MPI_COMM_WORLD);
-        MPI_Allreduce(MPI_IN_PLACE, Affected.data(), Affected.size(), MPI_INT, MPI_MAX, MPI_COMM_WORLD);
+        frontier.toVector(work);
+        size_t boundary = std::partition(work.begin(), work.end(), [&](int v) { return ghosts.isBoundary(v); }) -
+                          work.begin();
+        relax_range(0, boundary);
+        next.clear();
+        post_changes(changed, labels, Tree, ghosts, seen, next);
+        ghosts.start();
+
+        for (size_t begin = boundary; begin < work.size(); begin += chunk) {
+            relax_range(begin, std::min(work.size(), begin + chunk));
+            ghosts.progress();
+        }
+        ghosts.finish(received);
+        post_changes(changed, labels, Tree, ghosts, seen, next);
+        apply_labels(received, labels, Tree, ghosts, next);
+        frontier.swap(next);
+        MPI_Wait(&pending_req, MPI_STATUS_IGNORE);
     }
+    labels.store(Dist, Parent);
 }
@@ -1,7 +1,8 @@
 #pragma once
 #include "graph_loader.h"
+#include "sssp_tree.h"
+#include "ghost_exchange.h"
 #include <vector>
-#include <set>
 #include <tuple>
 
 void ProcessCE(
@@ -13,19 +14,28 @@ void ProcessCE(
     std::vector<int>& AffectedDel,
     std::vector<int>& Affected,
     std::vector<std::tuple<int, int, int>>& Gu,
-    std::set<std::pair<int, int>>& Tree,
+    DistributedTree& Tree,
+    VertexMap& map,
+    GhostExchange& ghosts,
     int rank,
     int size
 );
 
+// How the update loops interleave work and label exchange: bulk-synchronous rounds, the
+// same rounds with interior work overlapping the exchange, or no rounds at all
+enum class UpdateSchedule { Rounds, Overlap, Async };
+
 void UpdateAffectedVertices(
     Graph& graph,
     std::vector<std::tuple<int, int, int>>& Gu,
-    std::set<std::pair<int, int>>& Tree,
+    DistributedTree& Tree,
     std::vector<long long>& Dist,
     std::vector<int>& Parent,
     std::vector<int>& AffectedDel,
     std::vector<int>& Affected,
+    const VertexMap& map,
+    GhostExchange& ghosts,
     int rank,
-    int size
+    int size,
+    UpdateSchedule schedule
 );
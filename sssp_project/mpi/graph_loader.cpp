@@ -1,38 +1,21 @@
 #include "graph_loader.h"
-#include <fstream>
-#include <sstream>
+#include "graph_io.h"
+#include "dist_loader.h"
 #include <iostream>
 
-Graph load_partitioned_graph(const std::string& graphFile, const std::string& partFile, int rank) {
-    std::ifstream gfile(graphFile);
-    std::ifstream pfile(partFile);
+Graph load_partitioned_graph(const std::string& graphFile, const PartitionSpec& spec, int rank,
+                             bool mapWholeGraph) {
+    int nprocs;
+    MPI_Comm_size(MPI_COMM_WORLD, &nprocs);
     Graph graph;
-    std::vector<int> partitions;
-
-    if (!gfile || !pfile) {
-        std::cerr << "Error opening graph or partition file\n";
+    if (mapWholeGraph && is_binary_graph(graphFile)) {
+        if (!map_partitioned_graph(graphFile, spec, rank, nprocs, graph)) return Graph();
         return graph;
     }
 
-    int p;
-    while (pfile >> p) partitions.push_back(p);
-
-    int vertex_id = 0;
-    std::string line;
-    while (std::getline(gfile, line)) {
-        if (partitions[vertex_id] != rank) {
-            vertex_id++;
-            continue;
-        }
-
-        std::istringstream iss(line);
-        int neighbor, weight = 1;
-        while (iss >> neighbor) {
-            graph.adjacencyList[vertex_id].push_back({neighbor - 1, weight});  // METIS uses 1-based indexing
-        }
-        graph.localVertices.push_back(vertex_id);
-        vertex_id++;
+    if (!load_distributed_graph(graphFile, spec, MPI_COMM_WORLD, graph)) {
+        std::cerr << "Error opening graph or partition file\n";
+        return Graph();
     }
-
     return graph;
 }
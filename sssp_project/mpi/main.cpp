@@ -1,12 +1,17 @@
 #include <mpi.h>
 #include <iostream>
 #include <vector>
-#include <set>
 #include <tuple>
 #include <limits>
 #include <fstream>
 #include "sssp_mpi.h"
 #include "graph_loader.h"
+#include "cli.h"
+#include "dist_delta_stepping.h"
+#include "dist_bfs.h"
+#include "dist_loader.h"
+#include "workload.h"
+#include "vertex_map.h"
 
 int main(int argc, char** argv) {
     MPI_Init(&argc, &argv);
@@ -15,109 +20,120 @@ int main(int argc, char** argv) {
     MPI_Comm_rank(MPI_COMM_WORLD, &rank);
     MPI_Comm_size(MPI_COMM_WORLD, &size);
 
-    std::string graphFile = "/mirror/test_graph.txt";
-    std::string partFile = "/mirror/test_graph.txt.part.8";
-    std::cout << "Rank " << rank << ": Reading graph from " << graphFile << ", partition from " << partFile << "\n";
-    Graph graph = load_partitioned_graph(graphFile, partFile, rank);
-
-    int num_vertices = 0;
-    std::ifstream pfile(partFile);
-    if (!pfile) {
-        std::cerr << "Rank " << rank << ": Error opening partition file " << partFile << "\n";
+    CommandLine cli(argc, argv);
+    std::string graphFile = cli.get("graph", "/mirror/test_graph.txt");
+    // Without --part the partition is computed at load time for the current rank count
+    PartitionSpec spec;
+    spec.file = cli.get("part", "");
+    spec.slack = cli.getDouble("slack", spec.slack);
+    if (!parse_partition_method(cli.get("partitioner", "fennel"), spec.method)) {
+        if (rank == 0) std::cerr << "Unknown partitioner " << cli.get("partitioner", "") << "\n";
         MPI_Abort(MPI_COMM_WORLD, 1);
     }
-    std::string line;
-    while (std::getline(pfile, line)) {
-        if (!line.empty()) {
-            num_vertices++;
-        }
-    }
-    pfile.close();
-    std::cout << "Rank " << rank << ": num_vertices = " << num_vertices << "\n";
+    std::cout << "Rank " << rank << ": Reading graph from " << graphFile << ", partition from "
+              << (spec.file.empty() ? cli.get("partitioner", "fennel") : spec.file) << "\n";
+    Graph graph = load_partitioned_graph(graphFile, spec, rank, cli.has("mmap"));
 
-    if (num_vertices != 6) {
-        std::cerr << "Rank " << rank << ": Error: Expected 6 vertices, got " << num_vertices << "\n";
+    int num_vertices = graph.numVertices();
+    if (num_vertices == 0) {
+        std::cerr << "Rank " << rank << ": Error loading graph " << graphFile << "\n";
         MPI_Abort(MPI_COMM_WORLD, 1);
     }
+    std::cout << "Rank " << rank << ": num_vertices = " << num_vertices << "\n";
 
-    const int INF = std::numeric_limits<int>::max();
-    std::vector<int> Dist(num_vertices, INF);
-    std::vector<int> Parent(num_vertices, -1);
-    std::vector<int> AffectedDel(num_vertices, 0);
-    std::vector<int> Affected(num_vertices, 0);
+    std::vector<int> Parent;
     std::vector<std::tuple<int, int, int>> Gu;
-    std::set<std::pair<int, int>> Tree;
 
+    // Initial tree: distributed BFS from vertex 0 when every edge weighs 1, distributed
+    // delta-stepping otherwise; either leaves the labels of the owned vertices correct
     std::cout << "Rank " << rank << ": Initializing tree\n";
-    if (rank == 0) {
-        Dist[0] = 0;
-        Dist[1] = 1;
-        Dist[2] = 3;
-        Dist[3] = 4;
-        Dist[4] = 7;
-        Dist[5] = 8;
-
-        Tree.insert({0, 1});
-        Tree.insert({1, 2});
-        Tree.insert({2, 3});
-        Tree.insert({3, 4});
-        Tree.insert({4, 5});
-
-        Parent[1] = 0;
-        Parent[2] = 1;
-        Parent[3] = 2;
-        Parent[4] = 3;
-        Parent[5] = 4;
+    int unit_weights = graph.unitWeights();
+    MPI_Allreduce(MPI_IN_PLACE, &unit_weights, 1, MPI_INT, MPI_LAND, MPI_COMM_WORLD);
+    std::vector<long long> initial_dist;
+    if (unit_weights) {
+        DistributedBFS bfs(graph, MPI_COMM_WORLD);
+        bfs.run(0, initial_dist, Parent);
+        std::cout << "Rank " << rank << ": BFS took " << bfs.levels() << " levels (" << bfs.bottomUpLevels()
+                  << " bottom-up), sent " << bfs.messages() << " messages\n";
+    } else {
+        DistributedDeltaStepping engine(graph, MPI_COMM_WORLD, cli.getInt("delta", 0));
+        engine.run(0, initial_dist, Parent);
+        std::cout << "Rank " << rank << ": Delta-stepping took " << engine.phases() << " phases, sent "
+                  << engine.messages() << " relaxation messages\n";
     }
 
-    std::cout << "Rank " << rank << ": Broadcasting Dist\n";
-    MPI_Bcast(Dist.data(), num_vertices, MPI_INT, 0, MPI_COMM_WORLD);
-    std::cout << "Rank " << rank << ": Broadcasting Parent\n";
-    MPI_Bcast(Parent.data(), num_vertices, MPI_INT, 0, MPI_COMM_WORLD);
-    std::vector<int> tree_data;
-    if (rank == 0) {
-        for (const auto& [u, v] : Tree) {
-            tree_data.push_back(u);
-            tree_data.push_back(v);
-        }
-    }
-    int tree_size = tree_data.size();
-    std::cout << "Rank " << rank << ": Broadcasting tree_size\n";
-    MPI_Bcast(&tree_size, 1, MPI_INT, 0, MPI_COMM_WORLD);
-    tree_data.resize(tree_size);
-    std::cout << "Rank " << rank << ": Broadcasting tree_data\n";
-    MPI_Bcast(tree_data.data(), tree_size, MPI_INT, 0, MPI_COMM_WORLD);
-    if (rank != 0) {
-        for (int i = 0; i < tree_size; i += 2) {
-            Tree.insert({tree_data[i], tree_data[i + 1]});
-        }
+    // From here on each rank keeps only its own vertices and their ghosts, numbered by the
+    // vertex map (owned first)
+    VertexMap map(graph, MPI_COMM_WORLD);
+    GhostExchange ghosts(graph, map, MPI_COMM_WORLD);
+    std::vector<int> Dist(map.size());
+    {
+        std::vector<long long> local_dist;
+        std::vector<int> full_parent;
+        full_parent.swap(Parent);
+        localize_labels(map, ghosts, initial_dist, full_parent, local_dist, Parent);
+        for (int v = 0; v < map.size(); ++v) Dist[v] = local_dist[v] == DIST_INF ? INF : (int)local_dist[v];
+        std::vector<long long>().swap(initial_dist);
     }
-
-    std::vector<std::pair<int, int>> Delk = {{2, 3}};
-    std::vector<std::tuple<int, int, int>> Insk = {{1, 5, 2}};
+    std::vector<int> AffectedDel(map.size(), 0);
+    std::vector<int> Affected(map.size(), 0);
+    DistributedTree Tree(map.numOwned(), Parent);
+
+    // Without --rounds one fixed batch: delete (2, 3), insert (1, 5, 2). With it, --rounds
+    // generated batches of --batch updates (see workload.h), each rank drawing its share
+    // from its own vertices.
+    WorkloadSpec workload;
+    if (!parse_workload_spec(cli, workload)) MPI_Abort(MPI_COMM_WORLD, 1);
+    WorkloadGenerator generator(graph, workload, rank);
+    int rounds = cli.getInt("rounds", 0);
+    long long batch_size = std::max(1LL, cli.getInt("batch", 2));
+    // --async replaces the update rounds by asynchronous label exchange
+    bool async = cli.has("async");
+    std::vector<EdgeUpdate> local;
 
     std::cout << "Rank " << rank << ": Before barrier\n";
     MPI_Barrier(MPI_COMM_WORLD);
     std::cout << "Rank " << rank << ": After barrier\n";
     double start = MPI_Wtime();
 
-    std::cout << "Rank " << rank << ": Starting ProcessCE\n";
-    ProcessCE(graph, Delk, Insk, Dist, Parent, AffectedDel, Affected, Gu, Tree, rank, size);
-    std::cout << "Rank " << rank << ": Starting UpdateAffectedVertices\n";
-    UpdateAffectedVertices(graph, Gu, Tree, Dist, Parent, AffectedDel, Affected, rank, size);
+    for (int round = 0; round < std::max(rounds, 1); ++round) {
+        std::vector<std::pair<int, int>> Delk = {{2, 3}};
+        std::vector<std::tuple<int, int, int>> Insk = {{1, 5, 2}};
+        if (rounds > 0) {
+            local.clear();
+            auto parent = [&](int v) {
+                int l = map.local(v);
+                return l < 0 || Parent[l] < 0 ? -1 : map.global(Parent[l]);
+            };
+            generator.generate(batch_size / size + (rank < batch_size % size), parent, local);
+            split_updates(allgather_updates(local, MPI_COMM_WORLD), Delk, Insk);
+            std::cout << "Rank " << rank << ": Update round " << round + 1 << "\n";
+        }
 
+        std::cout << "Rank " << rank << ": Starting ProcessCE\n";
+        ProcessCE(graph, Delk, Insk, Dist, Parent, AffectedDel, Affected, Gu, Tree, map, ghosts, rank, size);
+        std::cout << "Rank " << rank << ": Starting UpdateAffectedVertices\n";
+        UpdateAffectedVertices(graph, Gu, Tree, Dist, Parent, AffectedDel, Affected, map, ghosts, rank, size, async);
+    }
+
+    std::cout << "Rank " << rank << ": Sent " << ghosts.messages() << " labels to " << ghosts.neighborRanks()
+              << " neighbor ranks\n";
     std::cout << "Rank " << rank << ": Before final barrier\n";
     MPI_Barrier(MPI_COMM_WORLD);
     std::cout << "Rank " << rank << ": After final barrier\n";
     double end = MPI_Wtime();
 
+    std::vector<long long> owned_dist(map.numOwned());
+    for (int v = 0; v < map.numOwned(); ++v) owned_dist[v] = Dist[v] == INF ? -1 : Dist[v];
+    std::vector<long long> final_dist = gather_owned(map, owned_dist, -1, 0, MPI_COMM_WORLD);
+
     // Synchronize output to make it cleaner
     for (int r = 0; r < size; r++) {
         if (rank == r) {
             if (rank == 0) {
                 std::cout << "Final Distances:\n";
                 for (int i = 0; i < num_vertices; ++i) {
-                    std::cout << "Node " << i << ": " << (Dist[i] == INF ? -1 : Dist[i]) << "\n";
+                    std::cout << "Node " << i << ": " << final_dist[i] << "\n";
                 }
                 std::cout << "Execution Time: " << (end - start) << " seconds\n";
             }
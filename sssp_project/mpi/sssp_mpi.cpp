@@ -1,8 +1,66 @@
 #include "sssp_mpi.h"
 #include "graph_loader.h"
+#include "dist_loader.h"
+
+// Dist and Parent hold the vertices a rank owns and their ghosts, by the local ids of the
+// VertexMap; updates arrive with global ids and log lines print global ids. Changed labels
+// travel through the ghost exchange: a changed ghost goes to its owner as a proposal (or
+// an invalidation), and the owner settles it and passes the result on to every rank
+// holding the vertex as a ghost.
+
+namespace {
+
+long long to_wire(int d) { return d == INF ? DIST_INF : d; }
+int from_wire(long long d) { return d == DIST_INF ? INF : (int)d; }
+
+void set_label(int v, int d, int p, std::vector<int>& Dist, std::vector<int>& Parent, DistributedTree& Tree) {
+    Tree.setParent(v, p);
+    Dist[v] = d;
+    Parent[v] = p;
+}
+
+// Posts the changed vertices; owned ones are queued in next
+void post_changes(const Frontier& changed, const std::vector<int>& Dist, const std::vector<int>& Parent,
+                  GhostExchange& ghosts, Frontier& next) {
+    changed.forEach([&](int v) {
+        ghosts.post(v, to_wire(Dist[v]), Parent[v]);
+        if (ghosts.owns(v)) next.insert(v);
+    });
+}
+
+// A ghost takes the label its owner sent. An owned vertex takes a shorter proposal, or an
+// invalidation naming its current parent; an accepted change is queued in next and passed
+// on to the ghost holders, a refused one answers with the owner's label.
+void apply_labels(const std::vector<LabelMessage>& received, std::vector<int>& Dist, std::vector<int>& Parent,
+                  DistributedTree& Tree, GhostExchange& ghosts, Frontier& next) {
+    for (const LabelMessage& m : received) {
+        int v = m.v, d = from_wire(m.dist);
+        if (!ghosts.owns(v)) {
+            set_label(v, d, m.parent, Dist, Parent, Tree);
+            continue;
+        }
+        bool accepted = d == INF ? Parent[v] == m.parent && Dist[v] != INF : d < Dist[v];
+        if (accepted) {
+            set_label(v, d, m.parent, Dist, Parent, Tree);
+            next.insert(v);
+        } else if (Dist[v] == d && Parent[v] == m.parent) {
+            continue;
+        }
+        ghosts.post(v, to_wire(Dist[v]), Parent[v]);
+    }
+}
+
+// Collective. Rounds continue while any rank has a frontier or labels to send
+long long global_pending(const Frontier& frontier, const GhostExchange& ghosts) {
+    long long pending = frontier.size() + ghosts.queued();
+    MPI_Allreduce(MPI_IN_PLACE, &pending, 1, MPI_LONG_LONG, MPI_SUM, MPI_COMM_WORLD);
+    return pending;
+}
+
+} // namespace
 
 void ProcessCE(
-    const Graph& graph,
+    Graph& graph,
     const std::vector<std::pair<int, int>>& Delk,
     const std::vector<std::tuple<int, int, int>>& Insk,
     std::vector<int>& Dist,
@@ -10,145 +68,210 @@ void ProcessCE(
     std::vector<int>& AffectedDel,
     std::vector<int>& Affected,
     std::vector<std::tuple<int, int, int>>& Gu,
-    const std::set<std::pair<int, int>>& T,
+    DistributedTree& T,
+    VertexMap& map,
+    GhostExchange& ghosts,
     int rank,
     int size
 ) {
+    auto in_range = [&](int v) { return v >= 0 && v < map.numVertices(); };
+    auto local = [&](int v) { return in_range(v) ? map.local(v) : -1; };
+    auto owned = [&](int l) { return l >= 0 && map.owned(l); };
+
+    // Endpoints of edges inserted into this rank's rows become ghosts first, and both sides
+    // of a new cut edge send the label of their own endpoint across
+    std::vector<int> wanted;
+    for (const auto& [u, v, w] : Insk) {
+        if (!in_range(u) || !in_range(v)) continue;
+        if (owned(map.local(u))) wanted.push_back(v);
+        if (owned(map.local(v))) wanted.push_back(u);
+    }
+    map.addGhosts(wanted);
+    int n = map.size();
+    Dist.resize(n, INF);
+    Parent.resize(n, -1);
+    AffectedDel.resize(n, 0);
+    Affected.resize(n, 0);
+    T.resize(n);
+
+    std::vector<std::pair<int, int>> introductions;
+    for (const auto& [u, v, w] : Insk) {
+        int lu = local(u), lv = local(v);
+        if (lu < 0 || lv < 0) continue;
+        if (map.owned(lu)) {
+            int o = ghosts.addEdge(lu, lv);
+            if (o >= 0) introductions.push_back({o, lu});
+        }
+        if (map.owned(lv)) {
+            int o = ghosts.addEdge(lv, lu);
+            if (o >= 0) introductions.push_back({o, lv});
+        }
+    }
+    ghosts.refresh();
+    std::vector<LabelMessage> received;
+    for (const auto& [o, l] : introductions) ghosts.postTo(o, l, to_wire(Dist[l]), Parent[l]);
+    ghosts.exchange(received);
+    for (const LabelMessage& m : received) set_label(m.v, from_wire(m.dist), m.parent, Dist, Parent, T);
+
+    // Only ranks holding a row of one endpoint act on a change; both endpoints are owned
+    // or ghosts there, so their labels are current
+    auto acts = [&](int u, int v) { return u >= 0 && v >= 0 && (map.owned(u) || map.owned(v)); };
+    Frontier changed(n);
+
     std::cout << "Rank " << rank << ": Processing deletions\n";
     for (size_t i = 0; i < Delk.size(); ++i) {
-        int u = Delk[i].first;
-        int v = Delk[i].second;
-        if (T.count({u, v}) || T.count({v, u})) {
+        int u = local(Delk[i].first);
+        int v = local(Delk[i].second);
+        if (acts(u, v) && (Parent[v] == u || Parent[u] == v)) {
             int y = (Dist[u] > Dist[v]) ? u : v;
-            if (std::find(graph.localVertices.begin(), graph.localVertices.end(), y) != graph.localVertices.end()) {
-                Dist[y] = INF;
-                AffectedDel[y] = 1;
-                Affected[y] = 1;
-            }
+            Dist[y] = INF;
+            AffectedDel[y] = 1;
+            Affected[y] = 1;
+            changed.insert(y);
         }
     }
 
-    std::cout << "Rank " << rank << ": Allreduce after deletions\n";
-    MPI_Allreduce(MPI_IN_PLACE, Dist.data(), Dist.size(), MPI_INT, MPI_MIN, MPI_COMM_WORLD);
-    MPI_Allreduce(MPI_IN_PLACE, AffectedDel.data(), AffectedDel.size(), MPI_INT, MPI_MAX, MPI_COMM_WORLD);
-    MPI_Allreduce(MPI_IN_PLACE, Affected.data(), Affected.size(), MPI_INT, MPI_MAX, MPI_COMM_WORLD);
-
     std::cout << "Rank " << rank << ": Processing insertions\n";
     for (size_t i = 0; i < Insk.size(); ++i) {
         int u, v, w;
         std::tie(u, v, w) = Insk[i];
+        Gu.push_back({u, v, w});
+        u = local(u);
+        v = local(v);
+        if (!acts(u, v)) continue;
 
         int x, y;
         if (Dist[u] > Dist[v]) { x = v; y = u; }
         else { x = u; y = v; }
 
-        if (std::find(graph.localVertices.begin(), graph.localVertices.end(), y) != graph.localVertices.end()) {
-            if (Dist[y] > Dist[x] + w) {
-                Dist[y] = Dist[x] + w;
-                Parent[y] = x;
-                Affected[y] = 1;
-            }
+        if (Dist[x] != INF && Dist[y] > Dist[x] + w) {
+            set_label(y, Dist[x] + w, x, Dist, Parent, T);
+            Affected[y] = 1;
+            changed.insert(y);
         }
+    }
 
-        Gu.push_back({u, v, w});
+    // Rows of either endpoint follow the changes
+    for (const auto& [u, v] : Delk) {
+        if (owned(local(u))) graph.eraseEdge(map.row(local(u)), v);
+        if (owned(local(v))) graph.eraseEdge(map.row(local(v)), u);
+    }
+    for (const auto& [u, v, w] : Insk) {
+        if (!acts(local(u), local(v))) continue;
+        if (owned(local(u))) graph.insertEdge(map.row(local(u)), v, w);
+        if (owned(local(v))) graph.insertEdge(map.row(local(v)), u, w);
     }
 
-    std::cout << "Rank " << rank << ": Allreduce after insertions\n";
-    MPI_Allreduce(MPI_IN_PLACE, Dist.data(), Dist.size(), MPI_INT, MPI_MIN, MPI_COMM_WORLD);
-    MPI_Allreduce(MPI_IN_PLACE, Parent.data(), Parent.size(), MPI_INT, MPI_MAX, MPI_COMM_WORLD);
-    MPI_Allreduce(MPI_IN_PLACE, Affected.data(), Affected.size(), MPI_INT, MPI_MAX, MPI_COMM_WORLD);
+    // Both ranks of a cut edge act on its update, and the owner settles the label
+    Frontier touched(n);
+    post_changes(changed, Dist, Parent, ghosts, touched);
+    ghosts.exchange(received);
+    apply_labels(received, Dist, Parent, T, ghosts, touched);
+    touched.forEach([&](int v) {
+        Affected[v] = 1;
+        if (Dist[v] == INF) AffectedDel[v] = 1;
+    });
     std::cout << "Rank " << rank << ": Finished ProcessCE\n";
 }
-
 void UpdateAffectedVertices(
     const Graph& graph,
     const std::vector<std::tuple<int, int, int>>& Gu,
-    const std::set<std::pair<int, int>>& Tree,
+    DistributedTree& Tree,
     std::vector<int>& Dist,
     std::vector<int>& Parent,
     std::vector<int>& AffectedDel,
     std::vector<int>& Affected,
+    const VertexMap& map,
+    GhostExchange& ghosts,
     int rank,
-    int size
+    int size,
+    bool async
 ) {
-    const int MAX_ITERATIONS = 100;
     int iteration = 0;
 
+    // Each round walks only the owned vertices invalidated by the previous round, here or
+    // by a ghost holder of theirs. The owner of an invalidated vertex finds its children
+    // in the tree index; affected collects them for the general loop.
+    Frontier frontier(Dist.size()), next(Dist.size()), changed(Dist.size()), affected(Dist.size());
+    std::vector<LabelMessage> received;
     std::cout << "Rank " << rank << ": Updating affected vertices (deletions)\n";
-    while (std::any_of(AffectedDel.begin(), AffectedDel.end(), [](int b) { return b != 0; }) && iteration < MAX_ITERATIONS) {
-        std::cout << "Rank " << rank << ": Deletion loop iteration " << iteration << "\n";
-        for (int v : graph.localVertices) {
-            if (AffectedDel[v]) {
-                std::cout << "Rank " << rank << ": Processing vertex " << v << " with AffectedDel[" << v << "] = 1\n";
-                AffectedDel[v] = 0;
-
-                for (int c = 0; c < Dist.size(); ++c) {
-                    if (Parent[c] == v) {
-                        std::cout << "Rank " << rank << ": Setting Dist[" << c << "] = INF because Parent[" << c << "] = " << v << "\n";
-                        Dist[c] = INF;
-                        AffectedDel[c] = 1;
-                        Affected[c] = 1;
-                    }
-                }
-            }
-        }
-
-        std::cout << "Rank " << rank << ": Allreduce in deletion loop\n";
-        MPI_Allreduce(MPI_IN_PLACE, Dist.data(), Dist.size(), MPI_INT, MPI_MIN, MPI_COMM_WORLD);
-        MPI_Allreduce(MPI_IN_PLACE, AffectedDel.data(), AffectedDel.size(), MPI_INT, MPI_MAX, MPI_COMM_WORLD);
-        MPI_Allreduce(MPI_IN_PLACE, Affected.data(), Affected.size(), MPI_INT, MPI_MAX, MPI_COMM_WORLD);
-        iteration++;
-    }
-    if (iteration >= MAX_ITERATIONS) {
-        std::cerr << "Rank " << rank << ": Warning: Deletion loop exceeded " << MAX_ITERATIONS << " iterations\n";
-    }
+    take_owned_flags(map.numOwned(), Affected, affected, MPI_COMM_WORLD);
+    take_owned_flags(map.numOwned(), AffectedDel, frontier, MPI_COMM_WORLD);
+    auto invalidate_children = [&]() {
+        changed.clear();
+        frontier.forEach([&](int v) {
+            int gv = map.global(v);
+            std::cout << "Rank " << rank << ": Processing vertex " << gv << " with AffectedDel[" << gv << "] = 1\n";
+            Tree.forEachChild(v, [&](int c) {
+                if (Dist[c] == INF) return;  // already invalidated, or a parent cycle closing
+                int gc = map.global(c);
+                std::cout << "Rank " << rank << ": Setting Dist[" << gc << "] = INF because Parent[" << gc << "] = " << gv << "\n";
+                Dist[c] = INF;
+                changed.insert(c);
+            });
+        });
+    };
 
-    std::cout << "Rank " << rank << ": Updating affected vertices (general)\n";
-    iteration = 0;
-    std::vector<int> update_count(Dist.size(), 0);
-    const int MAX_UPDATES_PER_VERTEX = 5; // Lowered to prevent excessive updates
-
-    while (std::any_of(Affected.begin(), Affected.end(), [](int b) { return b != 0; }) && iteration < MAX_ITERATIONS) {
-        std::cout << "Rank " << rank << ": General loop iteration " << iteration << "\n";
-        std::cout << "Rank " << rank << ": Affected = [";
-        for (int i = 0; i < Affected.size(); ++i) {
-            std::cout << Affected[i] << (i < Affected.size() - 1 ? ", " : "");
-        }
-        std::cout << "]\n";
-
-        for (int v : graph.localVertices) {
-            if (Affected[v]) {
-                std::cout << "Rank " << rank << ": Processing vertex " << v << " with Affected[" << v << "] = 1\n";
-                Affected[v] = 0;
-
-                auto it = graph.adjacencyList.find(v);
-                if (it != graph.adjacencyList.end()) {
-                    for (const auto& edge : it->second) {
-                        int n = edge.dest;
-                        int w = edge.weight;
-
-                        if (Dist[v] != INF && update_count[n] < MAX_UPDATES_PER_VERTEX) { // Only update n if v has a finite distance
-                            if (Dist[n] > Dist[v] + w) {
-                                std::cout << "Rank " << rank << ": Updating Dist[" << n << "] from " << Dist[n] << " to " << (Dist[v] + w) << " via vertex " << v << "\n";
-                                Dist[n] = Dist[v] + w;
-                                Parent[n] = v;
-                                Affected[n] = 1;
-                                update_count[n]++;
-                            }
-                        }
-                    }
+    // Improvements to ghosts are proposals: the owner keeps the smallest distance and
+    // hands it to every ghost holder
+    auto relax_frontier = [&]() {
+        changed.clear();
+        frontier.forEach([&](int v) {
+            int gv = map.global(v);
+            std::cout << "Rank " << rank << ": Processing vertex " << gv << " with Affected[" << gv << "] = 1\n";
+            graph.forEachEdge(map.row(v), [&](int gn, int w) {
+                int n = map.local(gn);
+                if (n < 0) return;
+                if (Dist[v] != INF && Dist[n] > Dist[v] + w) {
+                    std::cout << "Rank " << rank << ": Updating Dist[" << gn << "] from " << Dist[n] << " to " << (Dist[v] + w) << " via vertex " << gv << "\n";
+                    set_label(n, Dist[v] + w, v, Dist, Parent, Tree);
+                    changed.insert(n);
+                } else if (Dist[n] != INF && Dist[v] > Dist[n] + w) {
+                    // An invalidated vertex pulls from a neighbor that kept its distance
+                    std::cout << "Rank " << rank << ": Updating Dist[" << gv << "] from " << Dist[v] << " to " << (Dist[n] + w) << " via vertex " << gn << "\n";
+                    set_label(v, Dist[n] + w, n, Dist, Parent, Tree);
+                    changed.insert(v);
                 }
+            });
+        });
+    };
+
+    // Both loops run until nothing is left anywhere. Labels only fall in the general loop
+    // and are invalidated at most once in the deletion loop, so neither needs a cap.
+    // Rounds: every rank works its frontier, then all exchange the changed labels.
+    // Asynchronous: a rank sends its changed labels as soon as it has them and takes
+    // whatever has arrived, and a loop ends once the ghost exchange detects global
+    // quiescence.
+    auto run = [&](const char* name, auto&& step, auto&& accepted) {
+        iteration = 0;
+        for (;;) {
+            if (async) {
+                if (ghosts.quiescent(frontier.size() == 0 && ghosts.queued() == 0)) break;
+            } else {
+                long long pending = global_pending(frontier, ghosts);
+                if (pending == 0) break;
+                std::cout << "Rank " << rank << ": " << name << " loop iteration " << iteration << ", "
+                          << frontier.size() << " of " << pending << " vertices or labels local\n";
+            }
+            step();
+            next.clear();
+            post_changes(changed, Dist, Parent, ghosts, next);
+            if (async) {
+                ghosts.flush();
+                ghosts.poll(received);
+            } else {
+                ghosts.exchange(received);
             }
+            apply_labels(received, Dist, Parent, Tree, ghosts, next);
+            accepted();
+            frontier.swap(next);
+            iteration++;
         }
+    };
 
-        std::cout << "Rank " << rank << ": Allreduce in general loop\n";
-        MPI_Allreduce(MPI_IN_PLACE, Dist.data(), Dist.size(), MPI_INT, MPI_MIN, MPI_COMM_WORLD);
-        MPI_Allreduce(MPI_IN_PLACE, Parent.data(), Parent.size(), MPI_INT, MPI_MAX, MPI_COMM_WORLD);
-        MPI_Allreduce(MPI_IN_PLACE, Affected.data(), Affected.size(), MPI_INT, MPI_MAX, MPI_COMM_WORLD);
-        iteration++;
-    }
-    if (iteration >= MAX_ITERATIONS) {
-        std::cerr << "Rank " << rank << ": Warning: General loop exceeded " << MAX_ITERATIONS << " iterations\n";
-    }
+    run("Deletion", invalidate_children, [&]() { next.forEach([&](int v) { affected.insert(v); }); });
+    std::cout << "Rank " << rank << ": Updating affected vertices (general)\n";
+    frontier.swap(affected);
+    run("General", relax_frontier, []() {});
     std::cout << "Rank " << rank << ": Finished UpdateAffectedVertices\n";
 }
@@ -1,17 +1,18 @@
 #pragma once
 #include <vector>
-#include <set>
 #include <tuple>
 #include <limits>
 #include <algorithm>
 #include <mpi.h>
 #include <iostream>
 #include "graph_loader.h"
+#include "sssp_tree.h"
+#include "ghost_exchange.h"
 
 const int INF = std::numeric_limits<int>::max();
 
 void ProcessCE(
-    const Graph& graph,
+    Graph& graph,
     const std::vector<std::pair<int, int>>& Delk,
     const std::vector<std::tuple<int, int, int>>& Insk,
     std::vector<int>& Dist,
@@ -19,7 +20,9 @@ void ProcessCE(
     std::vector<int>& AffectedDel,
     std::vector<int>& Affected,
     std::vector<std::tuple<int, int, int>>& Gu,
-    const std::set<std::pair<int, int>>& T,
+    DistributedTree& T,
+    VertexMap& map,
+    GhostExchange& ghosts,
     int rank,
     int size
 );
@@ -27,11 +30,14 @@ void ProcessCE(
 void UpdateAffectedVertices(
     const Graph& graph,
     const std::vector<std::tuple<int, int, int>>& Gu,
-    const std::set<std::pair<int, int>>& Tree,
+    DistributedTree& Tree,
     std::vector<int>& Dist,
     std::vector<int>& Parent,
     std::vector<int>& AffectedDel,
     std::vector<int>& Affected,
+    const VertexMap& map,
+    GhostExchange& ghosts,
     int rank,
-    int size
+    int size,
+    bool async
 );
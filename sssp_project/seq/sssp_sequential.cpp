@@ -1,63 +1,53 @@
 #include <iostream>
 #include <vector>
-#include <set>
 #include <tuple>
 #include <limits>
-#include <fstream>
-#include <queue>
 #include <unordered_map>
 #include <algorithm>
 #include <sstream>
+#include <fstream>
 #include <chrono>
-
-struct Edge {
-    int dest;
-    int weight;
-};
-
-struct Graph {
-    std::vector<std::vector<Edge>> adjacencyList; // Use vector for zero-based IDs
-    std::vector<int> localVertices;
-};
-
-void buildTree(std::vector<int>& Parent, std::set<std::pair<int, int>>& Tree) {
-    Tree.clear();
-    for (int v = 0; v < Parent.size(); ++v) {
-        if (Parent[v] != -1) {
-            Tree.insert({Parent[v], v});
-        }
-    }
-    std::cout << "Tree built with " << Tree.size() << " edges\n";
-}
+#include "csr_graph.h"
+#include "graph_io.h"
+#include "cli.h"
+#include "bfs.h"
+#include "dijkstra.h"
+#include "multi_source.h"
+#include "point_to_point.h"
+#include "landmarks.h"
+#include "update_stream.h"
+#include "frontier.h"
+#include "sssp_tree.h"
+#include "workload.h"
+#include "distance_store.h"
+#include <memory>
+
+using Graph = CSRGraph;
 
 void ProcessCE(Graph& graph, std::vector<std::pair<int, int>>& Delk, std::vector<std::tuple<int, int, int>>& Insk,
-               std::vector<long long>& Dist, std::vector<int>& Parent, std::vector<bool>& AffectedDel,
-               std::vector<bool>& Affected, Graph& Gu, std::set<std::pair<int, int>>& Tree) {
+               std::vector<long long>& Dist, std::vector<int>& Parent, Frontier& AffectedDel,
+               Frontier& Affected, Graph& Gu, SSSPTree& Tree) {
     const long long INF = std::numeric_limits<long long>::max();
-    std::fill(AffectedDel.begin(), AffectedDel.end(), false);
-    std::fill(Affected.begin(), Affected.end(), false);
+    AffectedDel.clear();
+    Affected.clear();
 
     std::cout << "Processing " << Delk.size() << " deletions\n";
     for (const auto& edge : Delk) {
         int u = edge.first;
         int v = edge.second;
         std::cout << "Deleting edge (" << u << ", " << v << ")\n";
-        if (Tree.count({u, v}) || Tree.count({v, u})) {
+        if (Tree.isTreeEdge(u, v)) {
             int y = (Dist[u] > Dist[v]) ? u : v;
             if (y < Dist.size()) {
                 Dist[y] = INF;
-                AffectedDel[y] = true;
-                Affected[y] = true;
+                AffectedDel.insert(y);
+                Affected.insert(y);
                 std::cout << "Set Dist[" << y << "] to INF\n";
             }
         }
 
-        graph.adjacencyList[u].erase(std::remove_if(graph.adjacencyList[u].begin(), graph.adjacencyList[u].end(),
-                                                    [v](const Edge& e) { return e.dest == v; }),
-                                     graph.adjacencyList[u].end());
-        graph.adjacencyList[v].erase(std::remove_if(graph.adjacencyList[v].begin(), graph.adjacencyList[v].end(),
-                                                    [u](const Edge& e) { return e.dest == u; }),
-                                     graph.adjacencyList[v].end());
+        graph.eraseEdge(u, v);
+        graph.eraseEdge(v, u);
     }
 
     std::cout << "Processing " << Insk.size() << " insertions\n";
@@ -67,10 +57,10 @@ void ProcessCE(Graph& graph, std::vector<std::pair<int, int>>& Delk, std::vector
         int w = std::get<2>(edge);
         std::cout << "Inserting edge (" << u << ", " << v << ", " << w << ")\n";
 
-        graph.adjacencyList[u].push_back({v, w});
-        graph.adjacencyList[v].push_back({u, w});
-        Gu.adjacencyList[u].push_back({v, w});
-        Gu.adjacencyList[v].push_back({u, w});
+        graph.insertEdge(u, v, w);
+        graph.insertEdge(v, u, w);
+        Gu.insertEdge(u, v, w);
+        Gu.insertEdge(v, u, w);
 
         int x = (Dist[u] <= Dist[v]) ? u : v;
         int y = (x == u) ? v : u;
@@ -79,190 +69,240 @@ void ProcessCE(Graph& graph, std::vector<std::pair<int, int>>& Delk, std::vector
             (Dist[y] == INF || Dist[y] > Dist[x] + w)) {
             Dist[y] = Dist[x] + w;
             Parent[y] = x;
-            Affected[y] = true;
+            Tree.setParent(y, x);
+            Affected.insert(y);
             std::cout << "Updated Dist[" << y << "] to " << Dist[y] << "\n";
         }
     }
-
-    buildTree(Parent, Tree);
 }
 
-void UpdateAffectedVertices(Graph& graph, Graph& Gu, std::set<std::pair<int, int>>& Tree,
+void UpdateAffectedVertices(Graph& graph, Graph& Gu, SSSPTree& Tree,
                             std::vector<long long>& Dist, std::vector<int>& Parent,
-                            std::vector<bool>& AffectedDel, std::vector<bool>& Affected) {
+                            Frontier& AffectedDel, Frontier& Affected) {
     const long long INF = std::numeric_limits<long long>::max();
-    std::vector<std::vector<int>> children(Dist.size());
-
-    for (int v = 0; v < Parent.size(); ++v) {
-        if (Parent[v] != -1 && Parent[v] < children.size()) {
-            children[Parent[v]].push_back(v);
-        }
-    }
-
-    bool any_del_affected = true;
+    // Both phases walk only the vertices the previous round changed
+    Frontier next(Dist.size());
     int del_iterations = 0;
-    while (any_del_affected) {
-        any_del_affected = false;
-        for (int v = 0; v < AffectedDel.size(); ++v) {
-            if (AffectedDel[v]) {
-                AffectedDel[v] = false;
-                for (int c : children[v]) {
-                    if (c < Dist.size()) {
-                        Dist[c] = INF;
-                        AffectedDel[c] = true;
-                        Affected[c] = true;
-                        any_del_affected = true;
-                        std::cout << "Set Dist[" << c << "] to INF (child of " << v << ")\n";
-                    }
-                }
-            }
-        }
+    while (!AffectedDel.empty()) {
+        AffectedDel.forEach([&](int v) {
+            Tree.forEachChild(v, [&](int c) {
+                // Already invalidated; also stops the walk if an insertion in the same batch
+                // hung a deleted subtree below one of its own descendants
+                if (Dist[c] == INF) return;
+                Dist[c] = INF;
+                next.insert(c);
+                Affected.insert(c);
+                std::cout << "Set Dist[" << c << "] to INF (child of " << v << ")\n";
+            });
+        });
+        AffectedDel.clear();
+        AffectedDel.swap(next);
         ++del_iterations;
     }
     std::cout << "Deletion phase completed in " << del_iterations << " iterations\n";
 
-    bool any_affected = true;
+    // Unit weights: repair the invalidated region with a level-synchronous BFS instead
+    if (graph.unitWeights()) {
+        std::vector<int> affected;
+        Affected.toVector(affected);
+        Affected.clear();
+        DirectionOptimizingBFS bfs(graph);
+        long long improved = bfs.repair(affected, Dist, Parent);
+        std::cout << "BFS repair from " << affected.size() << " affected vertices updated " << improved
+                  << " distances in " << bfs.levels() << " levels\n";
+        Tree.sync(Parent);
+        return;
+    }
+
     int aff_iterations = 0;
-    while (any_affected) {
-        any_affected = false;
-        for (int v = 0; v < Affected.size(); ++v) {
-            if (Affected[v]) {
-                Affected[v] = false;
-                for (const auto& edge : graph.adjacencyList[v]) {
-                    int n = edge.dest;
-                    int w = edge.weight;
-                    if (Dist[v] != INF && (Dist[n] == INF || Dist[n] > Dist[v] + w)) {
-                        Dist[n] = Dist[v] + w;
-                        Parent[n] = v;
-                        Affected[n] = true;
-                        any_affected = true;
-                        std::cout << "Updated Dist[" << n << "] to " << Dist[v] + w << " via " << v << "\n";
-                    } else if (Dist[n] != INF && (Dist[v] == INF || Dist[v] > Dist[n] + w)) {
-                        Dist[v] = Dist[n] + w;
-                        Parent[v] = n;
-                        Affected[v] = true;
-                        any_affected = true;
-                        std::cout << "Updated Dist[" << v << "] to " << Dist[n] + w << " via " << n << "\n";
-                    }
+    while (!Affected.empty()) {
+        Affected.forEach([&](int v) {
+            graph.forEachEdge(v, [&](int n, int w) {
+                if (Dist[v] != INF && (Dist[n] == INF || Dist[n] > Dist[v] + w)) {
+                    Dist[n] = Dist[v] + w;
+                    Parent[n] = v;
+                    Tree.setParent(n, v);
+                    next.insert(n);
+                    std::cout << "Updated Dist[" << n << "] to " << Dist[v] + w << " via " << v << "\n";
+                } else if (Dist[n] != INF && (Dist[v] == INF || Dist[v] > Dist[n] + w)) {
+                    Dist[v] = Dist[n] + w;
+                    Parent[v] = n;
+                    Tree.setParent(v, n);
+                    next.insert(v);
+                    std::cout << "Updated Dist[" << v << "] to " << Dist[n] + w << " via " << n << "\n";
                 }
-            }
-        }
+            });
+        });
+        Affected.clear();
+        Affected.swap(next);
         ++aff_iterations;
     }
     std::cout << "Affected phase completed in " << aff_iterations << " iterations\n";
-
-    buildTree(Parent, Tree);
 }
 
-int main() {
+int main(int argc, char** argv) {
     auto start_total = std::chrono::high_resolution_clock::now();
-    std::string graphFile = "/mirror/facebook_combined.txt";
-    std::string partFile = "/mirror/facebook_graph.txt.part.8";
+    CommandLine cli(argc, argv);
+    std::string graphFile = cli.get("graph", "/mirror/facebook_combined.txt");
 
-    Graph graph;
     auto start_load = std::chrono::high_resolution_clock::now();
-    std::ifstream infile(graphFile);
-    if (!infile) {
-        std::cerr << "Error opening graph file " << graphFile << "\n";
+    TextFormat format;
+    if (!parse_text_format(cli.get("format", "edges"), format)) {
+        std::cerr << "Unknown graph format " << cli.get("format", "") << "\n";
         return 1;
     }
-
-    std::string line;
-    std::getline(infile, line);
-    std::istringstream header(line);
-    int num_vertices, num_edges;
-    header >> num_vertices >> num_edges;
-    std::cout << "Header: " << num_vertices << " vertices, " << num_edges << " edges\n";
-
-    // Resize adjacency list for zero-based nodes
-    graph.adjacencyList.resize(num_vertices);
-
-    // Read edges and ensure unique undirected edges
-    std::set<std::pair<int, int>> unique_edges;
-    while (std::getline(infile, line)) {
-        std::istringstream iss(line);
-        int u, v;
-        if (iss >> u >> v) {
-            int min_idx = std::min(u, v);
-            int max_idx = std::max(u, v);
-            unique_edges.insert({min_idx, max_idx});
-        }
+    QueueKind queue_kind;
+    if (!parse_queue_kind(cli.get("queue", "radix"), queue_kind)) {
+        std::cerr << "Unknown queue " << cli.get("queue", "") << "\n";
+        return 1;
     }
-    infile.close();
-
-    for (const auto& [u, v] : unique_edges) {
-        graph.adjacencyList[u].push_back({v, 1});
-        graph.adjacencyList[v].push_back({u, 1});
-        std::cout << "Added edge (" << u << ", " << v << ")\n";
+    LoadedGraph loaded;
+    if (!load_graph(graphFile, format, loaded)) {
+        return 1;
     }
-    std::cout << "Graph built with " << unique_edges.size() << " unique edges\n";
+    Graph graph = std::move(loaded.graph);
+    int num_vertices = graph.numVertices();
+    std::cout << "Graph built with " << num_vertices << " vertices, " << graph.numEntries() / 2 << " unique edges\n";
 
     // Log neighbor counts for key nodes
     for (int i = 0; i < std::min(5, num_vertices); ++i) {
-        std::cout << "Node " << i << " has " << graph.adjacencyList[i].size() << " neighbors\n";
+        std::cout << "Node " << i << " has " << graph.degree(i) << " neighbors\n";
     }
 
     auto end_load = std::chrono::high_resolution_clock::now();
     std::cout << "Graph loading took "
               << std::chrono::duration<double>(end_load - start_load).count() << " seconds\n";
 
-    std::ifstream pfile(partFile);
-    if (!pfile) {
-        std::cerr << "Error opening partition file " << partFile << "\n";
-        return 1;
+    // Multi-source mode: distances from every listed source instead of the update run
+    if (cli.has("sources")) {
+        std::vector<int> sources;
+        if (!read_source_list(cli.get("sources", ""), num_vertices, sources)) return 1;
+        auto start_ms = std::chrono::high_resolution_clock::now();
+        DistanceMatrix matrix;
+        multi_source_distances(graph, sources, matrix);
+        auto end_ms = std::chrono::high_resolution_clock::now();
+        std::cout << (graph.unitWeights() ? "Bit-parallel BFS" : "Batched Dijkstra") << " from " << sources.size()
+                  << " sources in batches of " << MS_BATCH << " took "
+                  << std::chrono::duration<double>(end_ms - start_ms).count() << " seconds\n";
+        for (size_t i = 0; i < std::min<size_t>(5, sources.size()); ++i) {
+            const int32_t* row = matrix.row(i);
+            long long reached = std::count_if(row, row + num_vertices, [](int32_t d) { return d >= 0; });
+            std::cout << "Source " << sources[i] << " reaches " << reached << " nodes\n";
+        }
+        if (cli.has("matrix")) {
+            if (!write_distance_matrix(cli.get("matrix", ""), matrix)) return 1;
+            std::cout << "Wrote " << sources.size() << " x " << num_vertices << " distance matrix to "
+                      << cli.get("matrix", "") << "\n";
+        }
+        return 0;
+    }
+
+    // Landmark index: --build-index FILE --landmarks K [--select degree|farthest]
+    if (cli.has("build-index")) {
+        LandmarkSelection selection;
+        if (!parse_landmark_selection(cli.get("select", "farthest"), selection)) {
+            std::cerr << "Unknown landmark selection " << cli.get("select", "") << "\n";
+            return 1;
+        }
+        auto start_idx = std::chrono::high_resolution_clock::now();
+        LandmarkIndex index;
+        index.build(graph, cli.getInt("landmarks", 16), selection);
+        auto end_idx = std::chrono::high_resolution_clock::now();
+        std::cout << "Built landmark index with " << index.landmarks().size() << " landmarks in "
+                  << std::chrono::duration<double>(end_idx - start_idx).count() << " seconds\n";
+        return index.save(cli.get("build-index", "")) ? 0 : 1;
     }
 
-    graph.localVertices.clear();
-    int vertex_count = 0;
-    while (std::getline(pfile, line)) {
-        if (vertex_count < num_vertices) {
-            graph.localVertices.push_back(vertex_count);
-            ++vertex_count;
+    // Point-to-point mode: --from S --to T for one query, --queries FILE for "s t" pairs.
+    // With --index FILE queries run A* on landmark bounds, or with --approx return the
+    // landmark upper bound in O(k) without searching.
+    if (cli.has("from") || cli.has("queries")) {
+        PointToPoint p2p(graph);
+        LandmarkIndex index;
+        bool use_index = cli.has("index");
+        if (use_index && (!index.load(cli.get("index", "")) || index.numVertices() != num_vertices)) {
+            std::cerr << "Landmark index " << cli.get("index", "") << " does not match the graph\n";
+            return 1;
+        }
+        bool approx = use_index && cli.has("approx");
+        long long expanded = 0;
+        auto answer = [&](int s, int t, std::vector<int>* path) {
+            if (approx) return index.bounds(s, t).second;
+            if (use_index) {
+                long long d = index.exact(graph, s, t, path);
+                expanded += index.lastSettled();
+                return d;
+            }
+            long long d = p2p.distance(s, t);
+            expanded += p2p.lastSettled();
+            if (path) *path = p2p.path(s, t);
+            return d;
+        };
+
+        if (cli.has("from")) {
+            int s = cli.getInt("from", 0), t = cli.getInt("to", 0);
+            if (use_index) {
+                auto [lower, upper] = index.bounds(s, t);
+                std::cout << "Landmark bounds: " << (lower == DIST_INF ? -1 : lower) << " <= d <= "
+                          << (upper == DIST_INF ? -1 : upper) << "\n";
+            }
+            if (approx) return 0;
+            std::vector<int> path;
+            long long d = answer(s, t, &path);
+            if (d == DIST_INF) {
+                std::cout << "No path from " << s << " to " << t << "\n";
+                return 0;
+            }
+            std::cout << "Distance from " << s << " to " << t << ": " << d << " (" << expanded
+                      << " nodes expanded)\nPath:";
+            for (int v : path) std::cout << " " << v;
+            std::cout << "\n";
+            return 0;
         }
+        std::ifstream qfile(cli.get("queries", ""));
+        if (!qfile) {
+            std::cerr << "Error opening query file " << cli.get("queries", "") << "\n";
+            return 1;
+        }
+        std::vector<std::pair<int, int>> queries;
+        int s, t;
+        while (qfile >> s >> t) queries.push_back({s, t});
+        std::vector<long long> answers(queries.size());
+        auto start_q = std::chrono::high_resolution_clock::now();
+        for (size_t i = 0; i < queries.size(); ++i) answers[i] = answer(queries[i].first, queries[i].second, nullptr);
+        double secs = std::chrono::duration<double>(std::chrono::high_resolution_clock::now() - start_q).count();
+        for (size_t i = 0; i < std::min<size_t>(10, queries.size()); ++i) {
+            std::cout << "Distance " << queries[i].first << " -> " << queries[i].second << ": "
+                      << (answers[i] == DIST_INF ? -1 : answers[i]) << "\n";
+        }
+        std::cout << queries.size() << (approx ? " approximate" : "") << " queries took " << secs << " seconds ("
+                  << (secs > 0 ? queries.size() / secs : 0) << " per second), "
+                  << (queries.empty() ? 0 : expanded / (long long)queries.size()) << " nodes expanded per query\n";
+        return 0;
     }
-    pfile.close();
-    std::cout << "Loaded " << vertex_count << " vertices from partition file\n";
 
     const long long INF = std::numeric_limits<long long>::max();
     std::vector<long long> Dist(num_vertices, INF);
     std::vector<int> Parent(num_vertices, -1);
-    std::vector<bool> AffectedDel(num_vertices, false);
-    std::vector<bool> Affected(num_vertices, false);
-    std::vector<bool> visited(num_vertices, false);
+    Frontier AffectedDel(num_vertices);
+    Frontier Affected(num_vertices);
     std::vector<long long> initialDist(num_vertices, INF);
-    Graph Gu;
-    Gu.adjacencyList.resize(num_vertices);
-   std::set<std::pair<int, int>> Tree;
-    // Dijkstra's algorithm
+    Graph Gu = Graph::fromEntries(num_vertices, {});
+    // Initial SSSP: BFS when every edge has weight 1, Dijkstra otherwise
     auto start_dijkstra = std::chrono::high_resolution_clock::now();
     int source = 0;
-    Dist[source] = 0;
-    std::priority_queue<std::pair<long long, int>, std::vector<std::pair<long long, int>>, std::greater<>> pq;
-    pq.push({0, source});
-    std::cout << "Starting Dijkstra from source " << source << "\n";
-
-    int nodes_processed = 0;
-    while (!pq.empty()) {
-        int u = pq.top().second;
-        long long d = pq.top().first;
-        pq.pop();
-
-        if (visited[u]) continue;
-        visited[u] = true;
-        ++nodes_processed;
-
-        std::cout << "Processing node " << u << " with distance " << d << "\n";
-        for (const auto& edge : graph.adjacencyList[u]) {
-            int v = edge.dest, w = edge.weight;
-            if (!visited[v] && Dist[v] > Dist[u] + w) {
-                Dist[v] = Dist[u] + w;
-                Parent[v] = u;
-                pq.push({Dist[v], v});
-                std::cout << "Updated Dist[" << v << "] to " << Dist[v] << " via " << u << "\n";
-            }
-        }
+    if (graph.unitWeights()) {
+        std::cout << "Starting direction-optimizing BFS from source " << source << "\n";
+        DirectionOptimizingBFS bfs(graph);
+        bfs.run(source, Dist, Parent);
+        int reached = std::count_if(Dist.begin(), Dist.end(), [&](long long d) { return d != INF; });
+        std::cout << "BFS completed in " << bfs.levels() << " levels (" << bfs.bottomUpLevels()
+                  << " bottom-up), reached " << reached << " nodes\n";
+    } else {
+        std::cout << "Starting Dijkstra (" << cli.get("queue", "radix") << " queue) from source " << source << "\n";
+        long long nodes_processed = dijkstra(graph, source, queue_kind, Dist, Parent);
+        std::cout << "Dijkstra completed, processed " << nodes_processed << " nodes\n";
     }
-    std::cout << "Dijkstra completed, processed " << nodes_processed << " nodes\n";
 
     // Store and log initial distances
     initialDist = Dist;
@@ -280,66 +320,60 @@ int main() {
     }
 
     auto end_dijkstra = std::chrono::high_resolution_clock::now();
-    std::cout << "Dijkstra took "
+    std::cout << "Initial SSSP took "
               << std::chrono::duration<double>(end_dijkstra - start_dijkstra).count() << " seconds\n";
 
-    buildTree(Parent, Tree);
-
-    // Collect tree and non-tree edges
-    std::vector<std::pair<int, int>> treeEdges, nonTreeEdges;
-    for (int u = 0; u < num_vertices; ++u) {
-        for (const auto& edge : graph.adjacencyList[u]) {
-            int v = edge.dest;
-            if (u < v) {
-                if (Tree.count({u, v}) || Tree.count({v, u})) {
-                    treeEdges.push_back({u, v});
-                } else {
-                    nonTreeEdges.push_back({u, v});
-                }
-            }
-        }
-    }
-    std::cout << "Found " << treeEdges.size() << " tree edges and " << nonTreeEdges.size() << " non-tree edges\n";
+    SSSPTree Tree(Parent);
+    std::cout << "Tree built with " << Tree.numEdges() << " edges\n";
+
+    // Dynamic updates: batches of --batch records from --updates FILE, otherwise --rounds
+    // generated batches (default 20 batches of 2 updates drawn from --mix, default 1:1
+    // insert:delete; see workload.h)
+    std::string updatesFile = cli.get("updates", "");
+    UpdateStream stream;
+    if (!updatesFile.empty() && !stream.open(updatesFile, num_vertices)) return 1;
+    WorkloadSpec spec;
+    if (!parse_workload_spec(cli, spec)) return 1;
+    WorkloadGenerator generator(graph, spec);
+    int rounds = cli.getInt("rounds", 20);
+    size_t batch_size = std::max(1LL, cli.getInt("batch", updatesFile.empty() ? 2 : 1000));
+    std::vector<EdgeUpdate> batch;
+
+    // Queries read the snapshot of the last finished batch while the next one is applied.
+    // --readers N runs N threads of parent-chain queries against it during the updates.
+    VersionedDistances store;
+    store.reset(Dist, Parent);
+    std::unique_ptr<SnapshotReaders> readers;
+    if (cli.getInt("readers", 0) > 0) readers = std::make_unique<SnapshotReaders>(store, cli.getInt("readers", 0), spec.seed);
 
-    // Multiple dynamic updates
     auto start_updates = std::chrono::high_resolution_clock::now();
-    const int num_updates = 20; // Adjust to target ~80s
-    for (int update = 0; update < num_updates; ++update) {
-        std::cout << "\nDynamic update iteration " << update + 1 << "\n";
+    for (int update = 0;; ++update) {
         std::vector<std::pair<int, int>> Delk;
         std::vector<std::tuple<int, int, int>> Insk;
-
-        if (!treeEdges.empty()) {
-            Delk.push_back(treeEdges[update % treeEdges.size()]);
-        } else if (!nonTreeEdges.empty()) {
-            Delk.push_back(nonTreeEdges[update % nonTreeEdges.size()]);
+        if (!updatesFile.empty()) {
+            if (!stream.next(batch_size, batch)) break;
+            std::cout << "\nUpdate batch " << update + 1 << ": " << batch.size() << " records\n";
+        } else {
+            if (update == rounds) break;
+            batch.clear();
+            generator.generate(batch_size, Parent, batch);
+            std::cout << "\nDynamic update iteration " << update + 1 << ": " << batch.size() << " generated updates\n";
         }
-        std::cout << "Selected " << Delk.size() << " edge(s) for deletion\n";
-
-        for (int i = 0; i < num_vertices; ++i) {
-            for (int j = i + 1; j < num_vertices; ++j) {
-                if (Dist[i] != INF && Dist[j] != INF) {
-                    bool connected = false;
-                    for (const auto& edge : graph.adjacencyList[i]) {
-                        if (edge.dest == j) {
-                            connected = true;
-                            break;
-                        }
-                    }
-                    if (!connected) {
-                        Insk.emplace_back(i, j, 1);
-                        std::cout << "Selected edge (" << i << ", " << j << ") for insertion\n";
-                        break;
-                    }
-                }
-            }
-            if (!Insk.empty()) break;
-        }
-
+        split_updates(batch, Delk, Insk);
         ProcessCE(graph, Delk, Insk, Dist, Parent, AffectedDel, Affected, Gu, Tree);
         UpdateAffectedVertices(graph, Gu, Tree, Dist, Parent, AffectedDel, Affected);
+        size_t pages = store.commit(Dist, Parent);
+        std::cout << "Committed epoch " << store.snapshot()->epoch() << ", " << pages << " pages copied\n";
+    }
+    if (readers) {
+        ReadStats stats = readers->stop();
+        std::cout << "Served " << stats.queries << " queries during updates, mean " << stats.mean_us << " us, max "
+                  << stats.max_us << " us, across " << stats.epochs << " epochs\n";
     }
 
+    if (stream.failed()) return 1;
+    if (!updatesFile.empty()) std::cout << "Applied " << stream.consumed() << " updates from " << updatesFile << "\n";
+
     auto end_updates = std::chrono::high_resolution_clock::now();
     std::cout << "Dynamic updates took "
               << std::chrono::duration<double>(end_updates - start_updates).count() << " seconds\n";
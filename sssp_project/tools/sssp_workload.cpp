@@ -0,0 +1,67 @@
+#include <iostream>
+#include <chrono>
+#include "cli.h"
+#include "dijkstra.h"
+#include "graph_io.h"
+#include "update_stream.h"
+#include "workload.h"
+
+// Generates a synthetic update stream for a graph, for runs that should replay the
+// same workload (--updates FILE). Batches are applied to the graph as they are drawn,
+// so deletions always name live edges; tree edges are those of the SSSP tree from
+// --source on the original graph.
+int main(int argc, char** argv) {
+    CommandLine cli(argc, argv);
+    std::string input = cli.get("input", "");
+    std::string output = cli.get("output", "");
+    long long count = cli.getInt("count", 0);
+    size_t batch_size = std::max(1LL, cli.getInt("batch", 1000));
+    TextFormat format;
+    WorkloadSpec spec;
+
+    if (input.empty() || output.empty() || count <= 0 || !parse_text_format(cli.get("format", "edges"), format) ||
+        !parse_workload_spec(cli, spec)) {
+        std::cerr << "Usage: sssp_workload --input graph --output updates --count N [--format metis|edges|snap]\n"
+                  << "                     [--batch 1000] [--binary] [--source 0] [--seed 1] [--mix 1:1:0]\n"
+                  << "                     [--tree-deletions 1] [--locality 0] [--hub-bias 0] [--max-weight 1]\n";
+        return 1;
+    }
+
+    LoadedGraph loaded;
+    if (!load_graph(input, format, loaded)) return 1;
+    CSRGraph& graph = loaded.graph;
+    int source = cli.getInt("source", 0);
+    if (source < 0 || source >= graph.numVertices()) {
+        std::cerr << "Source " << source << " is not a vertex of " << input << "\n";
+        return 1;
+    }
+    std::vector<long long> dist;
+    std::vector<int> parent;
+    dijkstra(graph, source, QueueKind::Radix, dist, parent);
+
+    auto start = std::chrono::high_resolution_clock::now();
+    WorkloadGenerator generator(graph, spec);
+    std::vector<EdgeUpdate> updates, batch;
+    std::vector<std::pair<int, int>> deletions;
+    std::vector<std::tuple<int, int, int>> insertions;
+    while ((long long)updates.size() < count) {
+        batch.clear();
+        generator.generate(std::min<long long>(batch_size, count - updates.size()), parent, batch);
+        if (batch.empty()) break;
+        split_updates(batch, deletions, insertions);
+        for (auto& [u, v] : deletions) {
+            graph.eraseEdge(u, v);
+            graph.eraseEdge(v, u);
+        }
+        for (auto& [u, v, w] : insertions) {
+            graph.insertEdge(u, v, w);
+            graph.insertEdge(v, u, w);
+        }
+        updates.insert(updates.end(), batch.begin(), batch.end());
+    }
+    double secs = std::chrono::duration<double>(std::chrono::high_resolution_clock::now() - start).count();
+
+    if (!write_update_stream(output, updates, cli.has("binary"))) return 1;
+    std::cout << "Generated " << updates.size() << " updates in " << secs << " seconds, wrote " << output << "\n";
+    return 0;
+}